@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <frc/Filesystem.h>
+
+#include "Arm/ArmKinematics.h"
+#include "Arm/TwoJointArmProfiles.h"
+
+// Every profile csv in the deploy directory, so this is mostly file IO
+static void BM_ArmProfilesRead(benchmark::State &state)
+{
+    DirectoryStorage storage(frc::filesystem::GetDeployDirectory());
+    for (auto _ : state)
+    {
+        TwoJointArmProfiles profiles(storage);
+        profiles.readProfiles();
+    }
+}
+BENCHMARK(BM_ArmProfilesRead)->Unit(benchmark::kMillisecond);
+
+static void BM_ArmProfilesGetTheta(benchmark::State &state)
+{
+    DirectoryStorage storage(frc::filesystem::GetDeployDirectory());
+    TwoJointArmProfiles profiles(storage);
+    profiles.readProfiles();
+    std::pair<TwoJointArmProfiles::Positions, TwoJointArmProfiles::Positions> key{TwoJointArmProfiles::STOWED, TwoJointArmProfiles::HIGH};
+
+    double time = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(profiles.getThetaProfile(key, time));
+        time = time > 2 ? 0 : time + LoopConstants::SEQUENCING_PERIOD;
+    }
+}
+BENCHMARK(BM_ArmProfilesGetTheta);
+
+static void BM_ArmKinematicsXYToAng(benchmark::State &state)
+{
+    double x = -0.5;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ArmKinematics::xyToAng(x, 1, true));
+        x = x > 0.5 ? -0.5 : x + 0.01;
+    }
+}
+BENCHMARK(BM_ArmKinematicsXYToAng);
@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "Vision/SocketClient.h"
+
+// Parses what comes in off the socket in one recv, heartbeats and detections the way the jetson sends them
+class SocketClientBench
+{
+public:
+    static void parseFrames(benchmark::State &state)
+    {
+        SocketClient client("127.0.0.1", 0, 0, 0);
+
+        std::string buffer;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            buffer += "0^1,7,3.5128,-1.2045,12.8734,0.0231," + std::to_string(i) + ",1682012345.123456$\n";
+        }
+
+        for (auto _ : state)
+        {
+            std::string pending = buffer;
+            client.m_ParseFrames(pending, 0);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+};
+
+static void BM_SocketClientParseFrames(benchmark::State &state)
+{
+    SocketClientBench::parseFrames(state);
+}
+BENCHMARK(BM_SocketClientParseFrames)->Arg(1)->Arg(8);
@@ -0,0 +1,15 @@
+#include <benchmark/benchmark.h>
+
+#include "Drivebase/SwerveDrive.h"
+
+// Range is the priority, the others only do extra work when a module saturates so the command is past what it can do
+static void BM_SwerveDriveCalcModules(benchmark::State &state)
+{
+    SwerveDrive swerveDrive;
+    SwerveDrive::DrivePriority priority = static_cast<SwerveDrive::DrivePriority>(state.range(0));
+    for (auto _ : state)
+    {
+        swerveDrive.calcModules(SwerveConstants::MAX_TELE_VEL, 0.5 * SwerveConstants::MAX_TELE_VEL, 0, 0, 0.8, 0, true, priority);
+    }
+}
+BENCHMARK(BM_SwerveDriveCalcModules)->Arg(SwerveDrive::UNIFORM)->Arg(SwerveDrive::TRANSLATION)->Arg(SwerveDrive::ROTATION);
@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "Helpers/MotionProfile.h"
+#include "Helpers/TrajectoryCalc.h"
+#include "Drivebase/LineupPlanner.h"
+#include "Drivebase/SwervePath.h"
+
+// Same limits as the auto paths' x trajectory
+static void BM_TrajectoryCalcGenerate(benchmark::State &state)
+{
+    TrajectoryCalc traj(SwerveConstants::MAX_LV, SwerveConstants::MAX_LA, 0, 0, 0, 0);
+    double setPos = 1;
+    for (auto _ : state)
+    {
+        traj.generateTrajectory(0, setPos, 0.5);
+        setPos = -setPos;
+    }
+}
+BENCHMARK(BM_TrajectoryCalcGenerate);
+
+static void BM_TrajectoryCalcGetProfile(benchmark::State &state)
+{
+    TrajectoryCalc traj(SwerveConstants::MAX_LV, SwerveConstants::MAX_LA, 0, 0, 0, 0);
+    traj.generateTrajectory(0, 4, 0);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(traj.getProfile());
+    }
+}
+BENCHMARK(BM_TrajectoryCalcGetProfile);
+
+// Range is the number of points
+static void addPoints(SwervePath &path, int points)
+{
+    for (int i = 0; i < points; ++i)
+    {
+        path.addPoint(SwervePose(i * 1.5, (i % 2) * 0.5, i * 30, 0));
+    }
+}
+
+static void BM_SwervePathGenerateLinear(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        SwervePath path(SwerveConstants::MAX_LA, SwerveConstants::MAX_LV, SwerveConstants::MAX_AA, SwerveConstants::MAX_AV);
+        addPoints(path, state.range(0));
+        path.generateLinearTrajectory();
+    }
+}
+BENCHMARK(BM_SwervePathGenerateLinear)->Arg(2)->Arg(4)->Arg(8);
+
+static void BM_SwervePathGetPose(benchmark::State &state)
+{
+    SwervePath path(SwerveConstants::MAX_LA, SwerveConstants::MAX_LV, SwerveConstants::MAX_AA, SwerveConstants::MAX_AV);
+    addPoints(path, state.range(0));
+    path.generateLinearTrajectory();
+
+    double time = 0;
+    bool end = false;
+    for (auto _ : state)
+    {
+        SwervePose *pose = path.getPose(time, end);
+        benchmark::DoNotOptimize(pose->getX());
+        delete pose;
+
+        time = end ? 0 : time + LoopConstants::SEQUENCING_PERIOD;
+    }
+}
+BENCHMARK(BM_SwervePathGetPose)->Arg(2)->Arg(4)->Arg(8);
+
+static void BM_MotionProfileSCurve(benchmark::State &state)
+{
+    MotionProfile::Goal goal{0, 0.5, 3, 0, {SwerveConstants::MAX_LV, SwerveConstants::MAX_LA, 20}};
+    for (auto _ : state)
+    {
+        MotionProfile profile(goal);
+        benchmark::DoNotOptimize(profile.getDuration());
+    }
+}
+BENCHMARK(BM_MotionProfileSCurve);
+
+// A whole profile at the sequencing rate, the way a path gets previewed
+static void BM_MotionProfileSampleBatch(benchmark::State &state)
+{
+    MotionProfile profile({0, 0, 3, 0, {SwerveConstants::MAX_LV, SwerveConstants::MAX_LA, 20}});
+    std::vector<MotionProfile::State> out(profile.getDuration() / LoopConstants::SEQUENCING_PERIOD + 1);
+    for (auto _ : state)
+    {
+        profile.sample(0, LoopConstants::SEQUENCING_PERIOD, out.data(), out.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+BENCHMARK(BM_MotionProfileSampleBatch);
+
+static void BM_MotionProfileSynchronize(benchmark::State &state)
+{
+    std::array<MotionProfile::Goal, 3> goals{{{0, 0.3, 1.5, 0, {SwerveConstants::MAX_LV, SwerveConstants::MAX_LA, 20}},
+                                               {0, -0.2, 0.4, 0, {SwerveConstants::MAX_LV, SwerveConstants::MAX_LA, 20}},
+                                               {0, 0, 30, 0, {SwerveConstants::MAX_AV, SwerveConstants::MAX_AA, 0}}}};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(MotionProfile::synchronize(goals));
+    }
+}
+BENCHMARK(BM_MotionProfileSynchronize);
+
+// What the tag lineup does every tick it's tracking, the replan is a no-op unless the target moved
+static void BM_LineupPlannerTick(benchmark::State &state)
+{
+    TickClock clock;
+    LineupPlanner lineup(SwerveConstants::LINEUP_LV, SwerveConstants::LINEUP_LA, SwerveConstants::LINEUP_AV, SwerveConstants::LINEUP_AA);
+    lineup.setClock(&clock);
+    lineup.generate(1.2, 2.5, 80, 0.6, -0.3, 0, 1.9, 3.1, 90);
+
+    double time = 0;
+    for (auto _ : state)
+    {
+        clock.setTime(time);
+        lineup.replan(1.9, 3.1, 90, SwerveConstants::LINEUP_REPLAN_DIST);
+        benchmark::DoNotOptimize(lineup.getPose().getX());
+
+        time = (time > lineup.getDuration()) ? 0 : time + LoopConstants::CONTROL_PERIOD;
+    }
+}
+BENCHMARK(BM_LineupPlannerTick);
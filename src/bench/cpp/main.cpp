@@ -0,0 +1,14 @@
+#include <hal/HAL.h>
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv) {
+  HAL_Initialize(500, 0);
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,17 @@
+#include "Arm/ProfileStorage.h"
+
+#include <fstream>
+
+DirectoryStorage::DirectoryStorage(std::string directory) : directory_(directory)
+{
+}
+
+std::unique_ptr<std::istream> DirectoryStorage::open(const std::string &name)
+{
+    auto file = std::make_unique<std::ifstream>(directory_ + "/" + name);
+    if (!file->is_open())
+    {
+        return nullptr;
+    }
+    return file;
+}
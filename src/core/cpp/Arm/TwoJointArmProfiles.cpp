@@ -1,6 +1,6 @@
 #include "Arm/TwoJointArmProfiles.h"
 
-TwoJointArmProfiles::TwoJointArmProfiles()
+TwoJointArmProfiles::TwoJointArmProfiles(ProfileStorage &storage) : storage_(storage)
 {
     hasProfiles_ = false;
 }
@@ -23,9 +23,9 @@ void TwoJointArmProfiles::readProfiles()
 
 			std::pair<Positions, Positions> key{static_cast<Positions>(i), static_cast<Positions>(j)};
 			std::map<double, std::pair<std::tuple<double, double, double>, std::tuple<double, double, double>>> profile;
-            std::string fileName = frc::filesystem::GetDeployDirectory() + "/" + std::to_string(i) + std::to_string(j) + ".csv";
+            std::string fileName = std::to_string(i) + std::to_string(j) + ".csv";
 
-            std::ifstream infile(fileName);
+            std::unique_ptr<std::istream> infile = storage_.open(fileName);
 
             std::string data;
             double time, thetaPos, thetaVel, thetaAcc, phiPos, phiVel, phiAcc;
@@ -33,7 +33,7 @@ void TwoJointArmProfiles::readProfiles()
             bool valid;
             size_t c1, c2, c3, c4, c5, c6;
 
-            while (getline(infile, data))
+            while (infile && getline(*infile, data))
             {
                 valid = true;
 
@@ -117,8 +117,6 @@ void TwoJointArmProfiles::readProfiles()
             //std::pair<Positions, Positions> testKey{ STOWED, HIGH };
             //cout << get<1>(profiles_.at(key).upper_bound(0.1)->second.second) << endl;
             //0.1001, -8.09238, 165.943, -2.04329, -1.03383, -20.4125, -10.328
-            infile.close();
-
 		}
 
 	}
@@ -0,0 +1,120 @@
+#include "Drivebase/LineupPlanner.h"
+
+#include <algorithm>
+
+LineupPlanner::LineupPlanner(double maxLV, double maxLA, double maxAV, double maxAA) : MAX_LV(maxLV), MAX_LA(maxLA), MAX_AV(maxAV), MAX_AA(maxAA)
+{
+
+}
+
+/**
+ * @param maxLJ m/s^3, maxAJ deg/s^3, 0 for trapezoids, the default
+ */
+void LineupPlanner::setMaxJerk(double maxLJ, double maxAJ)
+{
+    maxLJ_ = maxLJ;
+    maxAJ_ = maxAJ;
+}
+
+void LineupPlanner::setClock(Clock *clock)
+{
+    clock_ = clock;
+}
+
+/**
+ * Plans from the robot's pose and field-oriented velocity, finishing stopped at the wanted pose
+ */
+void LineupPlanner::generate(double x, double y, double yaw, double xVel, double yVel, double yawVel, double wantedX, double wantedY, double wantedYaw)
+{
+    startTime_ = getTime();
+    startX_ = x;
+    startY_ = y;
+    wantedX_ = wantedX;
+    wantedY_ = wantedY;
+    wantedYaw_ = wantedYaw;
+
+    double dist = sqrt((wantedX - x) * (wantedX - x) + (wantedY - y) * (wantedY - y));
+    if (dist > 1e-6)
+    {
+        alongX_ = (wantedX - x) / dist;
+        alongY_ = (wantedY - y) / dist;
+    }
+    else
+    {
+        alongX_ = 1;
+        alongY_ = 0;
+        dist = 0;
+    }
+
+    double alongVel = xVel * alongX_ + yVel * alongY_;
+    double acrossVel = -xVel * alongY_ + yVel * alongX_;
+
+    // Both axes share one translation limit, across gets enough to brake what it starts with and along gets what's left,
+    // so the combined velocity, acceleration and jerk never go over it
+    double acrossShare = std::clamp(abs(acrossVel) / MAX_LV, MIN_ACROSS_SHARE, MAX_ACROSS_SHARE);
+    double alongShare = sqrt(1 - acrossShare * acrossShare);
+
+    MotionProfile::Goal goals[3] = {
+        {0, alongVel, dist, 0, {MAX_LV * alongShare, MAX_LA * alongShare, maxLJ_ * alongShare}},
+        {0, acrossVel, 0, 0, {MAX_LV * acrossShare, MAX_LA * acrossShare, maxLJ_ * acrossShare}},
+        {yaw, yawVel, wantedYaw, 0, {MAX_AV, MAX_AA, maxAJ_}}};
+    MotionProfile profiles[3];
+    duration_ = MotionProfile::synchronize(goals, profiles, 3);
+
+    along_ = profiles[0];
+    across_ = profiles[1];
+    yaw_ = profiles[2];
+}
+
+/**
+ * Starts a new plan from the current setpoint if the target moved more than threshold m (or deg for yaw)
+ *
+ * @return If it replanned
+ */
+bool LineupPlanner::replan(double wantedX, double wantedY, double wantedYaw, double threshold)
+{
+    double moved = sqrt((wantedX - wantedX_) * (wantedX - wantedX_) + (wantedY - wantedY_) * (wantedY - wantedY_));
+    if (moved <= threshold && abs(wantedYaw - wantedYaw_) <= threshold)
+    {
+        return false;
+    }
+
+    SwervePose pose = getPose();
+    generate(pose.getX(), pose.getY(), pose.getYaw(), pose.getXVel(), pose.getYVel(), pose.getYawVel(), wantedX, wantedY, wantedYaw);
+    return true;
+}
+
+/**
+ * Field-oriented setpoint for now, the wanted pose stopped once it's done
+ */
+SwervePose LineupPlanner::getPose()
+{
+    double time = getTime() - startTime_;
+    MotionProfile::State along = along_.sample(time);
+    MotionProfile::State across = across_.sample(time);
+    MotionProfile::State yaw = yaw_.sample(time);
+
+    double x = startX_ + along.pos * alongX_ - across.pos * alongY_;
+    double y = startY_ + along.pos * alongY_ + across.pos * alongX_;
+    double xVel = along.vel * alongX_ - across.vel * alongY_;
+    double yVel = along.vel * alongY_ + across.vel * alongX_;
+    double xAcc = along.acc * alongX_ - across.acc * alongY_;
+    double yAcc = along.acc * alongY_ + across.acc * alongX_;
+
+    return SwervePose(x, y, yaw.pos, xVel, yVel, yaw.vel, xAcc, yAcc, yaw.acc);
+}
+
+double LineupPlanner::getDuration()
+{
+    return duration_;
+}
+
+bool LineupPlanner::isDone()
+{
+    return getTime() - startTime_ >= duration_;
+}
+
+double LineupPlanner::getTime()
+{
+    return clock_ ? clock_->getTime() : Clock::getDefault().getTime();
+}
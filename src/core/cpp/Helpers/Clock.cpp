@@ -0,0 +1,38 @@
+#include "Helpers/Clock.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+    SteadyClock steadyClock;
+    std::atomic<Clock *> defaultClock{&steadyClock};
+}
+
+Clock &Clock::getDefault()
+{
+    return *defaultClock.load();
+}
+
+/**
+ * @param clock Has to outlive everything using the default, nullptr goes back to the steady clock
+ */
+void Clock::setDefault(Clock *clock)
+{
+    defaultClock.store(clock ? clock : &steadyClock);
+}
+
+double SteadyClock::getTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double TickClock::getTime()
+{
+    return time_;
+}
+
+void TickClock::setTime(double time)
+{
+    time_ = time;
+}
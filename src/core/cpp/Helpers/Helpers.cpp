@@ -26,9 +26,4 @@ namespace Helpers {
         double mod = ang - multiple; 
         return mod;
     }
-
-units::radian_t convertStepsToRadians(double val, double numStepsPerRevolution) {
-  double valRad = val * (2 * M_PI / numStepsPerRevolution);
-  return units::radian_t{valRad};
-}
 } // namespace Helpers
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "Helpers/MotionProfile.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int BISECTION_ITERATIONS = 60;
+    const int STRETCH_STEPS = 32;
+    const double MIN_CRUISE_VEL = 1e-9; // slowest cruise when stretching, anything slower is as good as stopped
+}
+
+/**
+ * @param duration 0 for as fast as the limits allow, longer stretches it by cruising slower. It only gets as long as
+ * the slowest cruise whose ramps still fit in the distance, one that can't stretch that far finishes early.
+ */
+MotionProfile::MotionProfile(const Goal &goal, double duration)
+{
+    const Limits &limits = goal.limits;
+    double dist = goal.endPos - goal.startPos;
+
+    // Going straight from the start velocity to the end one covers this much, more than that has to go faster in the
+    // positive direction and less has to go faster in the negative one. Past the start or end speed and 0 the ramps
+    // cover more distance the faster the cruise, so the fastest cruise that fits is a bisection.
+    int direction = (dist >= changeDist(goal.startVel, goal.endVel, limits)) ? 1 : -1;
+    double slowest = (direction == 1) ? std::max({goal.startVel, goal.endVel, 0.0}) : std::min({goal.startVel, goal.endVel, 0.0});
+    // A start faster than maxV ramps down to it like any other speed change, it never cruises above the limit unless
+    // the distance is too short to slow down that far with the jerk limit
+    double fastest = direction * limits.maxV;
+
+    double cruiseVel;
+    if (fits(goal, fastest, direction))
+    {
+        cruiseVel = fastest;
+    }
+    else if (slowest * direction > limits.maxV && fits(goal, fitEdge(goal, fastest, direction * MIN_CRUISE_VEL, direction), direction))
+    {
+        // Starting (or ending) over the limit, the ramps cover less the slower the cruise only some of the way down
+        cruiseVel = fitEdge(goal, fastest, direction * MIN_CRUISE_VEL, direction);
+    }
+    else if (!fits(goal, slowest, direction))
+    {
+        // Only with a jerk limit, when the start and end both go the other way, and stopping between them covers too
+        // much. No cruise, just changing to a speed between them and 0 covers the distance, straight (at the start or
+        // end speed) covers too little.
+        double lo = (direction == 1) ? std::max(goal.startVel, goal.endVel) : std::min(goal.startVel, goal.endVel);
+        double hi = slowest;
+        for (int i = 0; i < BISECTION_ITERATIONS; ++i)
+        {
+            double mid = (lo + hi) / 2;
+            if (fits(goal, mid, direction))
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        cruiseVel = lo;
+    }
+    else
+    {
+        double lo = slowest, hi = fastest;
+        for (int i = 0; i < BISECTION_ITERATIONS; ++i)
+        {
+            double mid = (lo + hi) / 2;
+            if (fits(goal, mid, direction))
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        cruiseVel = lo;
+    }
+
+    Plan best = plan(goal, cruiseVel);
+    if (duration > best.duration && cruiseVel * direction > 0)
+    {
+        // Slower cruise is longer, down to forever as it gets to 0, but only while the ramps still fit in the distance.
+        // Slower than where they stop fitting it would have to overshoot and come back, so that's as long as it gets.
+        // With a jerk limit that isn't always one interval, so it steps out from the fastest to where they stop fitting.
+        double lo = fitEdge(goal, cruiseVel, direction * MIN_CRUISE_VEL, direction), hi = cruiseVel;
+
+        if (plan(goal, lo).duration <= duration)
+        {
+            best = plan(goal, lo);
+        }
+        else
+        {
+            for (int i = 0; i < BISECTION_ITERATIONS; ++i)
+            {
+                double mid = (lo + hi) / 2;
+                if (plan(goal, mid).duration > duration)
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            best = plan(goal, hi);
+        }
+    }
+
+    segments_[0] = {0, 0, goal.startPos, goal.startVel, 0, 0};
+    addChange(goal.startVel, best.cruiseVel, limits);
+    addSegment(best.cruiseTime, 0, 0);
+    addChange(best.cruiseVel, goal.endVel, limits);
+    end_ = {goal.endPos, goal.endVel, 0};
+}
+
+/**
+ * Every profile finishes at the same time, that of the slowest one
+ *
+ * @param profiles Filled in, count of them
+ * @return The common duration in seconds
+ */
+double MotionProfile::synchronize(const Goal *goals, MotionProfile *profiles, size_t count)
+{
+    double duration = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        profiles[i] = MotionProfile(goals[i]);
+        duration = std::max(duration, profiles[i].getDuration());
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (profiles[i].getDuration() < duration)
+        {
+            profiles[i] = MotionProfile(goals[i], duration);
+        }
+    }
+    return duration;
+}
+
+/**
+ * Samples at start, start + step, ... in one pass over the segments
+ */
+void MotionProfile::sample(double start, double step, State *out, size_t count) const
+{
+    int segment = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        double time = start + step * i;
+        if (time <= 0 || time >= duration_ || numSegments_ == 0)
+        {
+            out[i] = sample(time);
+            continue;
+        }
+
+        while (segment < numSegments_ - 1 && time >= segments_[segment + 1].start)
+        {
+            ++segment;
+        }
+        while (segment > 0 && time < segments_[segment].start)
+        {
+            --segment;
+        }
+        out[i] = at(segments_[segment], time);
+    }
+}
+
+/**
+ * How long it takes to change speed by dv
+ */
+double MotionProfile::changeTime(double dv, const Limits &limits)
+{
+    dv = std::abs(dv);
+    if (limits.maxJ <= 0)
+    {
+        return dv / limits.maxA;
+    }
+
+    double jerkTime = limits.maxA / limits.maxJ;
+    if (dv >= limits.maxA * jerkTime)
+    {
+        return dv / limits.maxA + jerkTime;
+    }
+    return 2 * std::sqrt(dv / limits.maxJ);
+}
+
+/**
+ * Both ramps are symmetric, so the distance is the average of the velocities over the time
+ */
+double MotionProfile::changeDist(double v0, double v1, const Limits &limits)
+{
+    return (v0 + v1) / 2 * changeTime(v1 - v0, limits);
+}
+
+double MotionProfile::rampDist(const Goal &goal, double cruiseVel)
+{
+    return changeDist(goal.startVel, cruiseVel, goal.limits) + changeDist(cruiseVel, goal.endVel, goal.limits);
+}
+
+/**
+ * Steps from one cruise toward another until whether the ramps fit changes, then bisects that step
+ *
+ * @return The edge on the side that fits, to if it never changes
+ */
+double MotionProfile::fitEdge(const Goal &goal, double from, double to, int direction)
+{
+    bool fromFits = fits(goal, from, direction);
+    for (int i = 1; i <= STRETCH_STEPS; ++i)
+    {
+        double step = from + (to - from) * i / STRETCH_STEPS;
+        if (fits(goal, step, direction) != fromFits)
+        {
+            double same = from + (to - from) * (i - 1) / STRETCH_STEPS;
+            double changed = step;
+            for (int j = 0; j < BISECTION_ITERATIONS; ++j)
+            {
+                double mid = (same + changed) / 2;
+                if (fits(goal, mid, direction) == fromFits)
+                {
+                    same = mid;
+                }
+                else
+                {
+                    changed = mid;
+                }
+            }
+            return fromFits ? same : changed;
+        }
+    }
+    return to;
+}
+
+/**
+ * If the ramps to and from cruiseVel leave some distance (or none) to cruise in the direction
+ */
+bool MotionProfile::fits(const Goal &goal, double cruiseVel, int direction)
+{
+    return (rampDist(goal, cruiseVel) - (goal.endPos - goal.startPos)) * direction <= 0;
+}
+
+MotionProfile::Plan MotionProfile::plan(const Goal &goal, double cruiseVel)
+{
+    double cruiseDist = goal.endPos - goal.startPos - rampDist(goal, cruiseVel);
+    double cruiseTime = (std::abs(cruiseVel) < MIN_CRUISE_VEL) ? 0 : std::max(cruiseDist / cruiseVel, 0.0);
+    return {cruiseVel, cruiseTime, changeTime(cruiseVel - goal.startVel, goal.limits) + cruiseTime + changeTime(goal.endVel - cruiseVel, goal.limits)};
+}
+
+void MotionProfile::addChange(double v0, double v1, const Limits &limits)
+{
+    double dv = std::abs(v1 - v0);
+    double sign = (v1 > v0) ? 1 : -1;
+    if (dv == 0)
+    {
+        return;
+    }
+
+    if (limits.maxJ <= 0)
+    {
+        addSegment(dv / limits.maxA, sign * limits.maxA, 0);
+        return;
+    }
+
+    double jerkTime = limits.maxA / limits.maxJ;
+    if (dv >= limits.maxA * jerkTime)
+    {
+        addSegment(jerkTime, 0, sign * limits.maxJ);
+        addSegment(dv / limits.maxA - jerkTime, sign * limits.maxA, 0);
+        addSegment(jerkTime, sign * limits.maxA, -sign * limits.maxJ);
+    }
+    else
+    {
+        double peakTime = std::sqrt(dv / limits.maxJ);
+        addSegment(peakTime, 0, sign * limits.maxJ);
+        addSegment(peakTime, sign * limits.maxJ * peakTime, -sign * limits.maxJ);
+    }
+}
+
+/**
+ * Starts where the last one ended, with acc at the start (a trapezoid steps it)
+ */
+void MotionProfile::addSegment(double duration, double acc, double jerk)
+{
+    if (duration <= 0)
+    {
+        return;
+    }
+
+    Segment segment{duration_, duration, segments_[0].pos, segments_[0].vel, acc, jerk};
+    if (numSegments_ > 0)
+    {
+        const Segment &last = segments_[numSegments_ - 1];
+        State end = at(last, last.start + last.duration);
+        segment.pos = end.pos;
+        segment.vel = end.vel;
+    }
+
+    segments_[numSegments_++] = segment;
+    duration_ += duration;
+}
@@ -0,0 +1,196 @@
+#include "Helpers/TrajectoryCalc.h"
+
+TrajectoryCalc::TrajectoryCalc(double maxV, double maxA, double kP, double kD, double kV, double kA) : MAX_V(maxV), MAX_A(maxA), kP_(kP), kD_(kD), kV_(kV), kA_(kA), kVI_(0)
+{
+    
+}
+
+TrajectoryCalc::TrajectoryCalc(double maxV, double maxA, double kP, double kD, double kV, double kA, double kVI) : MAX_V(maxV), MAX_A(maxA), kP_(kP), kD_(kD), kV_(kV), kA_(kA), kVI_(kVI)
+{
+
+}
+
+
+void TrajectoryCalc::setKP(double kP)
+{
+    kP_ = kP;
+}
+
+void TrajectoryCalc::setKD(double kD)
+{
+    kD_ = kD;
+}
+
+void TrajectoryCalc::setKV(double kV)
+{
+    kV_ = kV;
+}
+
+void TrajectoryCalc::setKA(double kA)
+{
+    kA_ = kA;
+}
+
+void TrajectoryCalc::setKVI(double kVI)
+{
+    kVI_ = kVI;
+}
+
+/**
+ * @param maxJ 0 for trapezoids, the default
+ */
+void TrajectoryCalc::setMaxJerk(double maxJ)
+{
+    maxJ_ = maxJ;
+}
+
+void TrajectoryCalc::generateTrajectory(double pos, double setPos, double vel)
+{
+    startTime_ = getTime();
+
+    setPos_ = setPos;
+    initPos_ = pos;
+    initVel_ = vel;
+
+    profile_ = MotionProfile({pos, vel, setPos, 0, {MAX_V, MAX_A, maxJ_}});
+}
+
+// void TrajectoryCalc::generateVelTrajectory(double setVel, double vel)
+// {
+//     startTime_ = timer_.GetFPGATimestamp().value();
+
+//     double error = setVel - vel;
+//     initVel_ = vel;
+//     setVel_ = setVel;
+    
+//     if(abs(error) < 100)
+//     {
+//         accelTime_ = 0;
+//         direction_ = 0;
+//     }
+//     else
+//     {
+//         accelTime_ = abs(error / MAX_A);
+//         if(error > 0)
+//         {
+//             direction_ = 1;
+//         }
+//         else
+//         {
+//             direction_ = -1;
+//         }
+//     }
+
+// }
+
+std::tuple<double, double, double> TrajectoryCalc::getProfile()
+{
+    MotionProfile::State state = profile_.sample(getTime() - startTime_);
+    return std::tuple<double, double, double>(state.acc, state.vel, state.pos);
+}
+
+// pair<double, double> TrajectoryCalc::getVelProfile()
+// {
+//     double time = timer_.GetFPGATimestamp().value() - startTime_;
+//     double tA, tV;
+
+//     if(time >= accelTime_ || accelTime_ == 0)
+//     {
+//         tA = 0;
+//         tV = setVel_;
+//     }
+//     else if(time < accelTime_)
+//     {
+//         tA = MAX_A * direction_;
+//         tV = initVel_ + (MAX_A * direction_ * time);
+//     }
+
+//     return pair<double, double> (tA, tV);
+
+// }
+
+double TrajectoryCalc::calcPower(double pos, double vel)
+{
+    std::tuple<double, double, double> profile = getProfile();
+
+    double error = get<2>(profile) - pos;
+
+    //double absoluteError = (setPos_ - pos);
+    //double deltaAbsoluteError = absoluteError - prevAbsoluteError_;
+    //prevAbsoluteError_ = absoluteError;
+    double velError = get<1>(profile) - vel;
+    if(printError_)
+    {
+        std::cout << "TMError " << error << " TMVError " << velError << std::endl;
+    }
+    double kVVolts;
+    if(get<1>(profile) == 0)
+    {
+        kVVolts = 0;
+    }
+    else
+    {
+        kVVolts = (abs(get<1>(profile)) - kVI_) * kV_;
+        if(get<1>(profile) < 0)
+        {
+            kVVolts *= -1;
+        }
+    }
+
+    double power = (kP_ * error) + (kD_ * velError) + kVVolts + (get<0>(profile) * kA_);
+
+    if(abs(power) > GeneralConstants::MAX_VOLTAGE)
+    {
+        std::cout << "trapezoidal motion gains are shitting themselves" << std::endl;
+    }
+
+    power = std::clamp(power, -GeneralConstants::MAX_VOLTAGE, GeneralConstants::MAX_VOLTAGE);
+    return power;
+}
+
+// double TrajectoryCalc::calcVelPower(double vel)
+// {
+//     pair<double, double> profile = getVelProfile();
+
+//     double error = profile.second - vel;
+
+//     if(printError_)
+//     {
+//         frc::SmartDashboard::PutNumber("TMVError", error);
+//     }
+
+//     double kVVolts = (abs(profile.second) - kVI_) * kV_;
+//     if(profile.second == 0)
+//     {
+//         kVVolts = 0;
+//     }
+//     else if(profile.second < 0)
+//     {
+//         kVVolts *= -1;
+//     }
+
+//     double power = (kD_ * error) + (profile.first * kA_) + kVVolts;
+
+//     if(abs(power) > GeneralConstants::MAX_VOLTAGE)
+//     {
+//         cout << "trapezoidal motion gains are shitting themselves" << endl;
+//     }
+
+//     power = clamp(power, -GeneralConstants::MAX_VOLTAGE, GeneralConstants::MAX_VOLTAGE);
+//     return power;
+// }
+
+void TrajectoryCalc::setPrintError(bool printError)
+{
+    printError_ = printError;
+}
+
+void TrajectoryCalc::setClock(Clock *clock)
+{
+    clock_ = clock;
+}
+
+double TrajectoryCalc::getTime()
+{
+    return clock_ ? clock_->getTime() : Clock::getDefault().getTime();
+}
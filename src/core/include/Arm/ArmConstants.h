@@ -130,6 +130,15 @@ namespace TwoJointArmConstants
 
     const double SWINGTHROUGH_CLEARANCE = 15;
 
+    // Sim/ArmSim
+    const int SIM_MOTORS_PER_JOINT = 2;
+    const double SIM_ROTOR_MOI = 0.00002; // kg m^2 of one Falcon rotor, rough
+    const double SIM_SHOULDER_FRICTION = 2; // N m at the joint, gearbox and chain
+    const double SIM_ELBOW_FRICTION = 1; // N m at the joint
+    const double SIM_FRICTION_VEL = 0.02; // rad/s where friction gets to full strength, keeps it smooth
+    const double SIM_HARD_STOP_MARGIN = 5; // degrees past the soft limits that the arm physically stops
+    const double SIM_SUBSTEP = 0.0002; // s, short enough for the shoulder back emf at 244:1
+
 }
 
 namespace ClawConstants
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string>
+
+// Where the arm profile csvs come from, the deploy directory on the robot
+class ProfileStorage
+{
+public:
+	virtual ~ProfileStorage() = default;
+
+	// nullptr if there's no file by that name
+	virtual std::unique_ptr<std::istream> open(const std::string &name) = 0;
+};
+
+class DirectoryStorage : public ProfileStorage
+{
+public:
+	DirectoryStorage(std::string directory);
+
+	std::unique_ptr<std::istream> open(const std::string &name) override;
+
+private:
+	std::string directory_;
+};
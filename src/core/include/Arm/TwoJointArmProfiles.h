@@ -5,8 +5,7 @@
 #include <fstream>
 #include <string>
 
-#include "frc/Filesystem.h"
-#include <frc/smartdashboard/SmartDashboard.h>
+#include "Arm/ProfileStorage.h"
 
 class TwoJointArmProfiles
 {
@@ -25,7 +24,7 @@ public:
 		AUTO_STOW/*,
 		CONE_INTAKE*/
 	};
-	TwoJointArmProfiles();
+	TwoJointArmProfiles(ProfileStorage &storage);
 
 	void readProfiles();
 
@@ -33,6 +32,7 @@ public:
 	std::tuple<double, double, double> getPhiProfile(std::pair<Positions, Positions> key, double time);
 
 private:
+	ProfileStorage &storage_;
 	std::map<std::pair<Positions, Positions>, std::map<double, std::pair<std::tuple<double, double, double>, std::tuple<double, double, double>>>> profiles_; //Ok this is big but it makes the most sense at least to me
 
 	bool hasProfiles_;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <math.h>
+
+#include "Helpers/Clock.h"
+#include "Helpers/MotionProfile.h"
+#include "SwervePose.h"
+
+// Drives x, y and yaw to a target together. Translation is profiled along the straight line to the target, with
+// whatever velocity the robot has across the line braked out on a second axis, the two splitting one translation limit.
+// Yaw is stretched to finish with them, so every axis arrives at the same time instead of one finishing and the others
+// still creeping.
+//
+// replan() moves the target without a jump in the setpoint, it starts from wherever the old profile is.
+class LineupPlanner
+{
+    public:
+        LineupPlanner(double maxLV, double maxLA, double maxAV, double maxAA);
+
+        void setMaxJerk(double maxLJ, double maxAJ);
+        void setClock(Clock *clock);
+
+        void generate(double x, double y, double yaw, double xVel, double yVel, double yawVel, double wantedX, double wantedY, double wantedYaw);
+        bool replan(double wantedX, double wantedY, double wantedYaw, double threshold);
+
+        SwervePose getPose();
+        double getDuration();
+        bool isDone();
+
+    private:
+        double getTime();
+
+        const double MAX_LV, MAX_LA, MAX_AV, MAX_AA;
+        // fraction of the translation limits the across axis gets, the along axis gets the rest of the circle
+        static constexpr double MIN_ACROSS_SHARE = 0.1, MAX_ACROSS_SHARE = 0.7;
+        double maxLJ_ = 0, maxAJ_ = 0;
+
+        double startX_ = 0, startY_ = 0;
+        double alongX_ = 1, alongY_ = 0; // unit vector to the target, across is it turned 90 ccw
+        double wantedX_ = 0, wantedY_ = 0, wantedYaw_ = 0;
+        double startTime_ = 0, duration_ = 0;
+        MotionProfile along_, across_, yaw_;
+
+        Clock *clock_ = nullptr; // nullptr for the default
+};
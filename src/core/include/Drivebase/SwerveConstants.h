@@ -9,6 +9,7 @@ namespace SwerveConstants
     const double DRIVE_GEAR_RATIO = 1 / 6.12;
     const double SWIVEL_GEAR_RATIO = 1 / 12.8;
     const double MAX_TELE_VEL = 5.672;
+    const double MAX_STEER_RATE = 1080; // deg/s the steering target can move, about what the module can do
 
 
     const double POSE_HISTORY_LENGTH = 0.3;
@@ -46,6 +47,17 @@ namespace SwerveConstants
     const double MAX_AA = 360; // 270
     const double MAX_AV = 540; // 450
 
+    // Tag lineup, all the axes go together so the translation limits are for the robot, not each of x and y
+    const double LINEUP_LV = MAX_LV * 0.7;
+    const double LINEUP_LA = MAX_LA * 0.7;
+    const double LINEUP_AV = MAX_AV * 0.7;
+    const double LINEUP_AA = MAX_AA * 0.7;
+    const double LINEUP_REPLAN_DIST = 0.0254 / 2; // m the target has to move before the lineup replans to it
+
+    // Paths slow down while the wheels can't keep up, this much per second faster again once they can, never below the min
+    const double PATH_TIME_RECOVERY = 2;
+    const double MIN_PATH_TIME_SCALE = 0.1;
+
     const double klV = 0.502636; // If you increase pd, check auto lineup
     const double klVI = -0.359672;
     const double klA = 4.11;
@@ -71,4 +83,35 @@ namespace SwerveConstants
     const double SENDING_IT_MED_SPEED = 0.35; //Was 0.3
 
     const double SENDING_IT_TIME = 1.1; //was 0.9
+
+    // Runs the steering (motion magic) and drive velocity loops on the talons at 1 kHz, the rio only sends setpoints and feedforward
+    const bool ONBOARD_CLOSED_LOOP = false;
+    const double STEER_KP = 0.2; // talon units, 1023 = full output per tick of error
+    const double STEER_KD = 0.1;
+    const double STEER_CRUISE_VEL = 720; // deg/s of the module
+    const double STEER_ACCEL = 7200; // deg/s^2
+    const double DRIVE_KP = 0.05;
+
+    // Sim/SwerveSim
+    const double ROBOT_MASS = 60; // kg, with bumpers, battery and the arm
+    const double ROBOT_MOI = 7; // kg m^2 about the middle
+    const double WHEEL_COF = 1.1;
+    const double ROLLING_RESISTANCE = 0.02; // fraction of the normal force
+    const double STEER_MOI = 0.004; // kg m^2 of one module about its steering axis
+    const double STEER_FRICTION = 0.2; // N m
+    const double SIM_SLIP_VEL = 0.05; // m/s where friction gets to full strength, keeps it smooth
+    const double SIM_SUBSTEP = 0.0005; // s
+
+    // Drive feedforward, volts = kS + kV * v + kA * a. kS and kV are a line through both sets of characterization data
+    // (SwerveModule::move() and SwerveDrive::drive()), kA is 1 / klA.
+    const double DRIVE_KS = 0.6935; // V
+    const double DRIVE_KV = 2.0266; // V / (m/s)
+    const double DRIVE_KA = 1 / klA; // V / (m/s^2)
+    const double DRIVE_VEL_KP = 0.5; // V / (m/s) of error
+
+    // Per module DRIVE_KV multipliers, raise one if its wheel lags the others at the same command
+    const double TR_DRIVE_KV_SCALE = 1.0;
+    const double TL_DRIVE_KV_SCALE = 1.0;
+    const double BR_DRIVE_KV_SCALE = 1.0;
+    const double BL_DRIVE_KV_SCALE = 1.0;
 }
\ No newline at end of file
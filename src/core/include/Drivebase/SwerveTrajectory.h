@@ -1,7 +1,6 @@
 #pragma once
 
 #include <math.h>
-#include <frc/smartdashboard/SmartDashboard.h>
 
 #include "Helpers/Helpers.h"
 #include "SwervePose.h"
@@ -25,6 +25,46 @@ namespace GeneralConstants
 
     const double CONE_M = 0.652;
 
+    const std::string JETSON_HOST = "10.1.14.43";
+    const std::string SIM_JETSON_HOST = "127.0.0.1"; // Sim/FakeCoprocessor
+    const int JETSON_PORT = 5807;
+
+}
+
+namespace CANConstants
+{
+    const std::string RIO_BUS = "rio";
+    const std::string DRIVEBASE_BUS = "drivebase";
+
+    // Frame periods in ms. Signals the 2 ms control task reads (and its outputs) go every run, drive velocity only feeds
+    // odometry, the rest are slowed down to free up the bus. Keep an eye on CAN/drivebase/utilization when changing these
+    const int FAST_FRAME_PERIOD = 2;
+    const int DRIVE_FRAME_PERIOD = 10;
+    const int GENERAL_FRAME_PERIOD = 20;
+    const int CURRENT_FRAME_PERIOD = 20;
+    const int SLOW_FRAME_PERIOD = 100;
+    const int UNUSED_FRAME_PERIOD = 255; // max
+
+    const double BUS_STATUS_PERIOD = 0.5; // s
+}
+
+namespace LoopConstants
+{
+    // s, the fast task runs feedback (module steering, arm joints), the slow one sequencing (vision, auto, teleop drive)
+    const double CONTROL_PERIOD = 0.002;
+    const double CONTROL_OFFSET = 0.0005;
+    const double SEQUENCING_PERIOD = 0.01;
+    const double SEQUENCING_OFFSET = 0.001;
+}
+
+namespace ThreadConstants
+{
+    // The rio has 2 cores. The robot loop gets one, telemetry and vision share the other with the system
+    const int CONTROL_CORE = 1;
+    const int BACKGROUND_CORE = 0;
+
+    const int CONTROL_PRIORITY = 10;
+    const int NOTIFIER_PRIORITY = 40; // the HAL notifier thread wakes the control loop, so it has to be above it
 }
 
 namespace FieldConstants
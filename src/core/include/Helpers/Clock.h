@@ -0,0 +1,31 @@
+#pragma once
+
+// Where the core library gets the time from, so it doesn't need the FPGA. The robot program sets the default to its
+// TickClock on startup, off the robot it's the steady clock.
+class Clock
+{
+    public:
+        virtual ~Clock() = default;
+        virtual double getTime() = 0; // s
+
+        static Clock &getDefault();
+        static void setDefault(Clock *clock);
+};
+
+class SteadyClock : public Clock
+{
+    public:
+        double getTime() override;
+};
+
+// Only moves when it's set, once at the top of every loop, so everything that runs in a loop sees the same time no
+// matter how long the loop takes. Tests step it by hand.
+class TickClock : public Clock
+{
+    public:
+        double getTime() override;
+        void setTime(double time);
+
+    private:
+        double time_ = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// One axis going from a position and velocity to another in the least time the limits allow: change speed to a cruise
+// velocity, cruise, change speed to the end velocity. Each speed change is an S-curve with a jerk limit, or a plain
+// trapezoid ramp with maxJ 0. Everything is worked out in closed form (bisection where it isn't) into at most 7
+// constant-jerk segments, so making and sampling one never allocates.
+//
+// Several axes can be synchronized so they all finish at the time of the slowest one, the others just cruise slower.
+// Acceleration is taken to be 0 at both ends.
+class MotionProfile
+{
+    public:
+        struct Limits
+        {
+            double maxV, maxA;
+            double maxJ; // 0 for no jerk limit
+        };
+
+        struct State
+        {
+            double pos, vel, acc;
+        };
+
+        struct Goal
+        {
+            double startPos, startVel;
+            double endPos, endVel;
+            Limits limits;
+        };
+
+        static constexpr int MAX_SEGMENTS = 7;
+
+        constexpr MotionProfile() = default;
+        MotionProfile(const Goal &goal, double duration = 0);
+
+        constexpr double getDuration() const { return duration_; }
+        constexpr State sample(double time) const;
+        void sample(double start, double step, State *out, size_t count) const;
+
+        static double synchronize(const Goal *goals, MotionProfile *profiles, size_t count);
+        template <size_t N>
+        static std::array<MotionProfile, N> synchronize(const std::array<Goal, N> &goals);
+
+    private:
+        struct Segment
+        {
+            double start, duration; // s
+            double pos, vel, acc, jerk; // at the start
+        };
+
+        struct Plan
+        {
+            double cruiseVel, cruiseTime, duration;
+        };
+
+        static double changeTime(double dv, const Limits &limits);
+        static double changeDist(double v0, double v1, const Limits &limits);
+        static double rampDist(const Goal &goal, double cruiseVel);
+        static bool fits(const Goal &goal, double cruiseVel, int direction);
+        static double fitEdge(const Goal &goal, double from, double to, int direction);
+        static Plan plan(const Goal &goal, double cruiseVel);
+
+        void addChange(double v0, double v1, const Limits &limits);
+        void addSegment(double duration, double acc, double jerk);
+
+        static constexpr State at(const Segment &segment, double time);
+
+        std::array<Segment, MAX_SEGMENTS> segments_{};
+        int numSegments_ = 0;
+        double duration_ = 0;
+        State end_{0, 0, 0};
+};
+
+/**
+ * @param time s from the start, before it is the start and past the end is the end
+ */
+constexpr MotionProfile::State MotionProfile::sample(double time) const
+{
+    if (time >= duration_ || numSegments_ == 0)
+    {
+        return end_;
+    }
+    if (time <= 0)
+    {
+        return {segments_[0].pos, segments_[0].vel, segments_[0].acc};
+    }
+
+    int i = 0;
+    while (i < numSegments_ - 1 && time >= segments_[i + 1].start)
+    {
+        ++i;
+    }
+    return at(segments_[i], time);
+}
+
+constexpr MotionProfile::State MotionProfile::at(const Segment &segment, double time)
+{
+    double t = time - segment.start;
+    return {segment.pos + segment.vel * t + segment.acc * t * t / 2 + segment.jerk * t * t * t / 6,
+            segment.vel + segment.acc * t + segment.jerk * t * t / 2,
+            segment.acc + segment.jerk * t};
+}
+
+template <size_t N>
+std::array<MotionProfile, N> MotionProfile::synchronize(const std::array<Goal, N> &goals)
+{
+    std::array<MotionProfile, N> profiles;
+    synchronize(goals.data(), profiles.data(), N);
+    return profiles;
+}
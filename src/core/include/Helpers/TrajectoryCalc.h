@@ -1,10 +1,12 @@
 #pragma once
 #include <math.h>
+#include <algorithm>
 #include <iostream>
+#include <tuple>
 
-#include <frc/Timer.h>
-#include <frc/smartdashboard/SmartDashboard.h>
 #include "GeneralConstants.h"
+#include "Helpers/Clock.h"
+#include "Helpers/MotionProfile.h"
 
 class TrajectoryCalc
 {
@@ -17,6 +19,7 @@ class TrajectoryCalc
         void setKV(double kV);
         void setKA(double kA);
         void setKVI(double kVI);
+        void setMaxJerk(double maxJ);
 
         void generateTrajectory(double pos, double setPos, double vel);
         //void generateVelTrajectory(double setVel, double vel);
@@ -28,17 +31,20 @@ class TrajectoryCalc
         //double calcVelPower(double vel);
 
         void setPrintError(bool printError);
+        void setClock(Clock *clock);
 
     private:
+        double getTime();
+
         const double MAX_V, MAX_A;
         double kP_, kD_, kV_, kA_, kVI_;
 
-        double /*prevAbsoluteError_,*/ setPos_, setVel_, initPos_, initVel_, startTime_;
+        double maxJ_ = 0;
 
-        int direction_;
-        double cruiseSpeed_, cruiseDist_, accelDist_, deccelDist_, cruiseTime_, accelTime_, deccelTime_;
+        double /*prevAbsoluteError_,*/ setPos_, setVel_, initPos_, initVel_, startTime_;
+        MotionProfile profile_;
 
         bool printError_ = false;
 
-        frc::Timer timer_;
+        Clock *clock_ = nullptr; // nullptr for the default
 };
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "Drivebase/LineupPlanner.h"
+#include "Helpers/Clock.h"
+
+namespace
+{
+    const double MAX_LV = 2.8, MAX_LA = 1.9, MAX_AV = 378, MAX_AA = 252;
+    const double TOLERANCE = 1e-6;
+
+    struct Peaks
+    {
+        double speed = 0, acc = 0;
+    };
+
+    // Peak combined translation speed and acceleration over the plan, from skip s in
+    Peaks sweep(LineupPlanner &planner, TickClock &clock, double start, double skip = 0)
+    {
+        Peaks peaks;
+        for (int i = 0; i <= 1000; ++i)
+        {
+            double time = planner.getDuration() * i / 1000;
+            if (time < skip)
+            {
+                continue;
+            }
+            clock.setTime(start + time);
+            SwervePose pose = planner.getPose();
+            peaks.speed = std::max(peaks.speed, std::hypot(pose.getXVel(), pose.getYVel()));
+            peaks.acc = std::max(peaks.acc, std::hypot(pose.getXAcc(), pose.getYAcc()));
+        }
+        return peaks;
+    }
+
+    void expectArrives(LineupPlanner &planner, TickClock &clock, double start, double x, double y, double yaw)
+    {
+        clock.setTime(start + planner.getDuration() + 1e-9);
+        EXPECT_TRUE(planner.isDone());
+        SwervePose pose = planner.getPose();
+        EXPECT_NEAR(pose.getX(), x, TOLERANCE);
+        EXPECT_NEAR(pose.getY(), y, TOLERANCE);
+        EXPECT_NEAR(pose.getYaw(), yaw, TOLERANCE);
+        EXPECT_NEAR(pose.getXVel(), 0, TOLERANCE);
+        EXPECT_NEAR(pose.getYVel(), 0, TOLERANCE);
+        EXPECT_NEAR(pose.getYawVel(), 0, TOLERANCE);
+    }
+}
+
+TEST(LineupPlannerTest, ArrivesStopped)
+{
+    TickClock clock;
+    LineupPlanner planner(MAX_LV, MAX_LA, MAX_AV, MAX_AA);
+    planner.setClock(&clock);
+
+    planner.generate(1, 1, 80, 0.5, -0.3, 0, 3, 2, 90);
+    EXPECT_FALSE(planner.isDone());
+    expectArrives(planner, clock, 0, 3, 2, 90);
+}
+
+// Moving sideways to the target, the along and across axes together still stay inside one translation limit
+TEST(LineupPlannerTest, SidewaysStartStaysWithinLimits)
+{
+    TickClock clock;
+    LineupPlanner planner(MAX_LV, MAX_LA, MAX_AV, MAX_AA);
+    planner.setClock(&clock);
+
+    for (double sideways : {0.0, 0.5, 1.5, MAX_LV * 0.9})
+    {
+        clock.setTime(0);
+        planner.generate(0, 0, 0, 0, sideways, 0, 4, 0, 0);
+        Peaks peaks = sweep(planner, clock, 0);
+        EXPECT_LE(peaks.speed, MAX_LV + TOLERANCE) << "sideways " << sideways;
+        EXPECT_LE(peaks.acc, MAX_LA + TOLERANCE) << "sideways " << sideways;
+        expectArrives(planner, clock, 0, 4, 0, 0);
+    }
+}
+
+// Coming in faster than the lineup limit it slows down to it rather than holding the speed it came in with
+TEST(LineupPlannerTest, FastStartSlowsDownToLimit)
+{
+    TickClock clock;
+    LineupPlanner planner(MAX_LV, MAX_LA, MAX_AV, MAX_AA);
+    planner.setClock(&clock);
+
+    const double SLOW_DOWN = 1; // s, long enough for every start below to get back under the limit
+    for (double maxJ : {0.0, 20.0})
+    {
+        planner.setMaxJerk(maxJ, 0);
+        for (auto [xVel, yVel] : {std::pair{4.0, 0.0}, {3.5, 2.0}, {0.5, 3.5}})
+        {
+            clock.setTime(0);
+            planner.generate(0, 0, 90, xVel, yVel, 0, 4, 0, 90);
+            Peaks peaks = sweep(planner, clock, 0, SLOW_DOWN);
+            EXPECT_LE(peaks.speed, MAX_LV + TOLERANCE) << "jerk " << maxJ << " start " << xVel << ", " << yVel;
+            EXPECT_LE(sweep(planner, clock, 0).acc, MAX_LA + TOLERANCE) << "jerk " << maxJ << " start " << xVel << ", " << yVel;
+            expectArrives(planner, clock, 0, 4, 0, 90);
+        }
+    }
+}
+
+TEST(LineupPlannerTest, JerkLimitedStaysWithinLimits)
+{
+    TickClock clock;
+    LineupPlanner planner(MAX_LV, MAX_LA, MAX_AV, MAX_AA);
+    planner.setClock(&clock);
+    planner.setMaxJerk(20, 2000);
+
+    planner.generate(2, -1, 0, -1, 1, 30, -1, 1, -45);
+    Peaks peaks = sweep(planner, clock, 0);
+    EXPECT_LE(peaks.speed, MAX_LV + TOLERANCE);
+    EXPECT_LE(peaks.acc, MAX_LA + TOLERANCE);
+    expectArrives(planner, clock, 0, -1, 1, -45);
+}
+
+TEST(LineupPlannerTest, ReplanKeepsSetpointContinuous)
+{
+    TickClock clock;
+    LineupPlanner planner(MAX_LV, MAX_LA, MAX_AV, MAX_AA);
+    planner.setClock(&clock);
+    planner.generate(1, 1, 80, 0.5, -0.3, 0, 3, 2, 90);
+
+    clock.setTime(0.5);
+    SwervePose before = planner.getPose();
+    EXPECT_FALSE(planner.replan(3.005, 2, 90, 0.02));
+    ASSERT_TRUE(planner.replan(3.1, 2, 90, 0.02));
+
+    SwervePose after = planner.getPose();
+    EXPECT_NEAR(after.getX(), before.getX(), TOLERANCE);
+    EXPECT_NEAR(after.getY(), before.getY(), TOLERANCE);
+    EXPECT_NEAR(after.getXVel(), before.getXVel(), TOLERANCE);
+    EXPECT_NEAR(after.getYVel(), before.getYVel(), TOLERANCE);
+    expectArrives(planner, clock, 0.5, 3.1, 2, 90);
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "Helpers/MotionProfile.h"
+
+namespace
+{
+    const double TOLERANCE = 1e-6;
+
+    // sample() snaps to the end state at the end, just before it is what the segments actually get to
+    MotionProfile::State justBeforeEnd(const MotionProfile &profile)
+    {
+        return profile.sample(profile.getDuration() - 1e-9);
+    }
+
+    void expectLands(const MotionProfile &profile, const MotionProfile::Goal &goal)
+    {
+        MotionProfile::State end = justBeforeEnd(profile);
+        EXPECT_NEAR(end.pos, goal.endPos, TOLERANCE);
+        EXPECT_NEAR(end.vel, goal.endVel, TOLERANCE);
+    }
+
+    // How long a start faster than maxV can take to get down to it
+    double slowDownTime(const MotionProfile::Goal &goal)
+    {
+        const MotionProfile::Limits &limits = goal.limits;
+        double over = std::abs(goal.startVel) - limits.maxV;
+        if (over <= 0)
+        {
+            return 0;
+        }
+        return over / limits.maxA + ((limits.maxJ > 0) ? limits.maxA / limits.maxJ : 0);
+    }
+
+    void expectWithinLimits(const MotionProfile &profile, const MotionProfile::Goal &goal)
+    {
+        double slowDown = slowDownTime(goal);
+        for (int i = 0; i <= 1000; ++i)
+        {
+            double time = profile.getDuration() * i / 1000;
+            MotionProfile::State state = profile.sample(time);
+            if (time >= slowDown)
+            {
+                EXPECT_LE(std::abs(state.vel), goal.limits.maxV + TOLERANCE) << "at " << time << " s";
+            }
+            EXPECT_LE(std::abs(state.acc), goal.limits.maxA + TOLERANCE) << "at " << time << " s";
+        }
+    }
+
+    const MotionProfile::Goal GOALS[] = {
+        {0, 0, 3, 0, {4, 2.75, 0}},         // cruises
+        {0, 0, 0.5, 0, {4, 2.75, 0}},       // triangle
+        {1, 0.5, -2, 0, {4, 2.75, 20}},     // turns around, S-curve
+        {0, 2, 1, 2, {3, 2, 0}},            // moving at both ends
+        {-0.803874, -0.296011, -1.22208, -0.00750138, {0.474733, 0.443472, 0.151815}}, // stopping covers too much
+        {0, 3, 0.2, -1, {2, 4, 30}},        // starts faster than the limit
+        {0, 5, 20, 0, {4, 2, 0}},           // starts faster than the limit with room to slow down
+        {0, 5, 20, 0, {4, 2, 20}},
+        {2, 0, 2, 0, {4, 2.75, 0}}};        // nowhere to go
+}
+
+TEST(MotionProfileTest, LandsOnEndState)
+{
+    for (const MotionProfile::Goal &goal : GOALS)
+    {
+        MotionProfile profile(goal);
+        expectLands(profile, goal);
+
+        MotionProfile::State end = profile.sample(profile.getDuration());
+        EXPECT_EQ(end.pos, goal.endPos);
+        EXPECT_EQ(end.vel, goal.endVel);
+    }
+}
+
+TEST(MotionProfileTest, StaysWithinLimits)
+{
+    for (const MotionProfile::Goal &goal : GOALS)
+    {
+        expectWithinLimits(MotionProfile(goal), goal);
+    }
+}
+
+TEST(MotionProfileTest, StartsAtStartState)
+{
+    for (const MotionProfile::Goal &goal : GOALS)
+    {
+        MotionProfile::State start = MotionProfile(goal).sample(0);
+        EXPECT_NEAR(start.pos, goal.startPos, TOLERANCE);
+        EXPECT_NEAR(start.vel, goal.startVel, TOLERANCE);
+    }
+}
+
+TEST(MotionProfileTest, SlowsDownToMaxVel)
+{
+    for (double maxJ : {0.0, 20.0})
+    {
+        MotionProfile::Goal goal{0, 5, 20, 0, {4, 2, maxJ}};
+        MotionProfile profile(goal);
+        double slowDown = slowDownTime(goal);
+        EXPECT_NEAR(profile.sample(slowDown).vel, 4, TOLERANCE);
+        EXPECT_NEAR(profile.sample(profile.getDuration() / 2).vel, 4, TOLERANCE);
+        expectLands(profile, goal);
+    }
+}
+
+TEST(MotionProfileTest, StretchFinishesAtDuration)
+{
+    MotionProfile::Goal goal{0, 0, 3, 0, {4, 2.75, 20}};
+    double fastest = MotionProfile(goal).getDuration();
+
+    MotionProfile profile(goal, fastest * 2);
+    EXPECT_NEAR(profile.getDuration(), fastest * 2, TOLERANCE);
+    expectLands(profile, goal);
+    expectWithinLimits(profile, goal);
+}
+
+TEST(MotionProfileTest, StretchWithEndVelocityNeverOvershoots)
+{
+    // Cruising any slower than this would take ramps longer than the distance, so it finishes early instead
+    MotionProfile::Goal goal{0, 2, 1, 2, {3, 2, 0}};
+    MotionProfile profile(goal, 1.5);
+    EXPECT_LE(profile.getDuration(), 1.5 + TOLERANCE);
+    expectLands(profile, goal);
+    expectWithinLimits(profile, goal);
+
+    for (int i = 0; i <= 1000; ++i)
+    {
+        EXPECT_LE(profile.sample(profile.getDuration() * i / 1000).pos, goal.endPos + TOLERANCE);
+    }
+}
+
+TEST(MotionProfileTest, StretchLandsForEveryGoal)
+{
+    for (const MotionProfile::Goal &goal : GOALS)
+    {
+        for (double scale : {1.1, 2.0, 5.0})
+        {
+            MotionProfile profile(goal, MotionProfile(goal).getDuration() * scale);
+            expectLands(profile, goal);
+            expectWithinLimits(profile, goal);
+        }
+    }
+}
+
+TEST(MotionProfileTest, SynchronizeFinishesTogether)
+{
+    std::array<MotionProfile::Goal, 3> goals{{{0, 0.3, 1.5, 0, {4, 2.75, 20}},
+                                              {0, -0.2, 0.4, 0, {4, 2.75, 20}},
+                                              {0, 0, 30, 0, {540, 360, 0}}}};
+    std::array<MotionProfile, 3> profiles = MotionProfile::synchronize(goals);
+
+    double duration = 0;
+    for (const MotionProfile::Goal &goal : goals)
+    {
+        duration = std::max(duration, MotionProfile(goal).getDuration());
+    }
+    for (size_t i = 0; i < goals.size(); ++i)
+    {
+        EXPECT_NEAR(profiles[i].getDuration(), duration, TOLERANCE);
+        expectLands(profiles[i], goals[i]);
+        expectWithinLimits(profiles[i], goals[i]);
+    }
+}
+
+TEST(MotionProfileTest, BatchSampleMatchesSample)
+{
+    MotionProfile profile(GOALS[2]);
+    const size_t count = 200;
+    std::array<MotionProfile::State, count> states;
+    double step = profile.getDuration() * 1.2 / count;
+    profile.sample(-0.1, step, states.data(), count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        MotionProfile::State state = profile.sample(-0.1 + step * i);
+        EXPECT_DOUBLE_EQ(states[i].pos, state.pos);
+        EXPECT_DOUBLE_EQ(states[i].vel, state.vel);
+        EXPECT_DOUBLE_EQ(states[i].acc, state.acc);
+    }
+}
@@ -0,0 +1,8 @@
+#include "gtest/gtest.h"
+
+// No HAL_Initialize, the core doesn't touch WPILib
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  return ret;
+}
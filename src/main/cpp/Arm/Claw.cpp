@@ -9,7 +9,6 @@ Claw::Claw() : clawPneumatic_(frc::PneumaticsModuleType::CTREPCM, ClawConstants:
 
 void Claw::periodic()
 {
-    frc::SmartDashboard::PutBoolean("Claw Open", open_);
     // frc::SmartDashboard::PutNumber("Claw Current", wheelMotor_.GetOutputCurrent());
 
     clawPneumatic_.Set(open_);
@@ -3,7 +3,9 @@
 TwoJointArm::TwoJointArm() : shoulderMaster_(TwoJointArmConstants::SHOULDER_MASTER_ID), shoulderSlave_(TwoJointArmConstants::SHOULDER_SLAVE_ID),
                              elbowMaster_(TwoJointArmConstants::ELBOW_MASTER_ID), elbowSlave_(TwoJointArmConstants::ELBOW_SLAVE_ID),
                              shoulderBrake_(frc::PneumaticsModuleType::CTREPCM, TwoJointArmConstants::SHOULDER_BRAKE_ID), elbowBrake_(frc::PneumaticsModuleType::CTREPCM, TwoJointArmConstants::ELBOW_BRAKE_ID), shoulderEncoder_(TwoJointArmConstants::SHOULDER_ENCODER_ID),
-                             shoulderTraj_(TwoJointArmConstants::SHOULDER_ARM_MAX_VEL, TwoJointArmConstants::SHOULDER_ARM_MAX_ACC, 0, 0, 0, 0), elbowTraj_(TwoJointArmConstants::ELBOW_ARM_MAX_VEL, TwoJointArmConstants::ELBOW_ARM_MAX_ACC, 0, 0, 0, 0)
+                             shoulderHealth_("Shoulder"), elbowHealth_("Elbow"),
+                             shoulderTraj_(TwoJointArmConstants::SHOULDER_ARM_MAX_VEL, TwoJointArmConstants::SHOULDER_ARM_MAX_ACC, 0, 0, 0, 0), elbowTraj_(TwoJointArmConstants::ELBOW_ARM_MAX_VEL, TwoJointArmConstants::ELBOW_ARM_MAX_ACC, 0, 0, 0, 0),
+                             profileStorage_(frc::filesystem::GetDeployDirectory()), movementProfiles_(profileStorage_)
 {
     shoulderMaster_.SetNeutralMode(NeutralMode::Brake);
     shoulderMaster_.SetInverted(true);
@@ -17,8 +19,16 @@ TwoJointArm::TwoJointArm() : shoulderMaster_(TwoJointArmConstants::SHOULDER_MAST
     elbowSlave_.Follow(elbowMaster_);
     elbowSlave_.SetInverted(InvertType::FollowMaster);
 
+    CANSignals::configureFeedbackMotor(shoulderMaster_, CANConstants::FAST_FRAME_PERIOD);
+    CANSignals::configureFeedbackMotor(elbowMaster_, CANConstants::FAST_FRAME_PERIOD);
+    CANSignals::setControlPeriod(shoulderMaster_, CANConstants::FAST_FRAME_PERIOD);
+    CANSignals::setControlPeriod(elbowMaster_, CANConstants::FAST_FRAME_PERIOD);
+    CANSignals::configureFollowerMotor(shoulderSlave_);
+    CANSignals::configureFollowerMotor(elbowSlave_);
+
     claw_.setOpen(false);
 
+    sample();
     movementProfiles_.readProfiles();
     state_ = STOPPED;
     position_ = TwoJointArmProfiles::STOWED;
@@ -123,7 +133,7 @@ void TwoJointArm::periodic()
     case FOLLOWING_TASK_SPACE_PROFILE:
     {
         setBrakes(false, false);
-        followTaskSpaceProfile(timer_.GetFPGATimestamp().value() - taskSpaceStartTime_);
+        followTaskSpaceProfile(Clock::getDefault().getTime() - taskSpaceStartTime_);
         break;
     }
     case FOLLOWING_JOINT_SPACE_PROFILE:
@@ -165,8 +175,39 @@ void TwoJointArm::periodic()
     // }
 }
 
+/**
+ * Reads every arm sensor once, everything else this loop uses these values
+ */
+const TwoJointArm::Sample &TwoJointArm::sample()
+{
+    sample_.shoulderEncoderPos = shoulderEncoder_.GetAbsolutePosition();
+    sample_.elbowMotorPos = elbowMaster_.GetSelectedSensorPosition();
+    sample_.shoulderMotorVel = shoulderMaster_.GetSelectedSensorVelocity();
+    shoulderHealth_.update(shoulderMaster_.GetLastError());
+    sample_.elbowMotorVel = elbowMaster_.GetSelectedSensorVelocity();
+    elbowHealth_.update(elbowMaster_.GetLastError());
+    sample_.shoulderCurrent = shoulderMaster_.GetSupplyCurrent();
+    sample_.elbowCurrent = elbowMaster_.GetSupplyCurrent();
+    return sample_;
+}
+
+void TwoJointArm::registerTelemetry(Telemetry &telemetry)
+{
+    clawOpenChannel_ = telemetry.addBoolean("Claw Open");
+    shoulderHealth_.registerTelemetry(telemetry);
+    elbowHealth_.registerTelemetry(telemetry);
+}
+
+void TwoJointArm::logTelemetry(Telemetry &telemetry)
+{
+    telemetry.log(clawOpenChannel_, claw_.isOpen());
+    shoulderHealth_.logTelemetry(telemetry);
+    elbowHealth_.logTelemetry(telemetry);
+}
+
 void TwoJointArm::zeroArms()
 {
+    sample();
     shoulderMaster_.SetSelectedSensorPosition(0);
     double theta = getTheta();
     if (!forward_)
@@ -175,6 +216,7 @@ void TwoJointArm::zeroArms()
     }
     double elbowPos = (180 + (theta * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO)) * 2048 / 360.0 / TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO / TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO;
     elbowMaster_.SetSelectedSensorPosition(elbowPos);
+    sample_.elbowMotorPos = elbowPos;
 
     // shoulderMaster_.setPos_(0);
     // elbowMaster_.setPos_(180);
@@ -186,6 +228,7 @@ void TwoJointArm::zeroArmsToAutoStow()
     double shoulderAng = TwoJointArmConstants::ARM_POSITIONS[TwoJointArmConstants::AUTO_STOW_NUM][2];
     double elbowAng = TwoJointArmConstants::ARM_POSITIONS[TwoJointArmConstants::AUTO_STOW_NUM][3];
 
+    sample();
     double shoulderPos = shoulderAng * 2048.0 / 360.0 / TwoJointArmConstants::MOTOR_TO_SHOULDER_RATIO;
     shoulderMaster_.SetSelectedSensorPosition(shoulderPos);
     // shoulderMaster_.setPos_(-18.5);
@@ -200,6 +243,7 @@ void TwoJointArm::zeroArmsToAutoStow()
     }
     double elbowPos = (elbowAng + (theta * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO)) * 2048 / 360.0 / TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO / TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO;
     elbowMaster_.SetSelectedSensorPosition(elbowPos);
+    sample_.elbowMotorPos = elbowPos;
     // elbowMaster_.setPos_(164.5);
 
     stop();
@@ -354,7 +398,7 @@ void TwoJointArm::setPosTo(TwoJointArmProfiles::Positions setPosition)
 
         setPosition_ = setPosition;
         state_ = FOLLOWING_TASK_SPACE_PROFILE;
-        taskSpaceStartTime_ = timer_.GetFPGATimestamp().value();
+        taskSpaceStartTime_ = Clock::getDefault().getTime();
     }
     else
     {
@@ -362,7 +406,7 @@ void TwoJointArm::setPosTo(TwoJointArmProfiles::Positions setPosition)
 
         setPosition_ = setPosition;
         state_ = FOLLOWING_TASK_SPACE_PROFILE;
-        taskSpaceStartTime_ = timer_.GetFPGATimestamp().value();
+        taskSpaceStartTime_ = Clock::getDefault().getTime();
     }
 }
 
@@ -437,7 +481,7 @@ void TwoJointArm::specialSetPosTo(TwoJointArmProfiles::Positions setPosition)
 
     setPosition_ = setPosition;
     state_ = FOLLOWING_TASK_SPACE_PROFILE;
-    taskSpaceStartTime_ = timer_.GetFPGATimestamp().value();
+    taskSpaceStartTime_ = Clock::getDefault().getTime();
 }
 
 void TwoJointArm::setBrakes(bool shoulder, bool elbow)
@@ -1683,9 +1727,9 @@ bool TwoJointArm::setShoulderVolts(double volts)
     double theta = getTheta();
     double phi = getPhi();
     std::pair<double, double> xy = ArmKinematics::angToXY(theta, phi);
-    if (shoulderMaster_.GetSupplyCurrent() > TwoJointArmConstants::STALL_SAFETY)
+    if (sample_.shoulderCurrent > TwoJointArmConstants::STALL_SAFETY)
     {
-        frc::SmartDashboard::PutNumber("SSC", shoulderMaster_.GetSupplyCurrent());
+        frc::SmartDashboard::PutNumber("SSC", sample_.shoulderCurrent);
         shoulderMaster_.SetVoltage(units::volt_t(0));
         elbowMaster_.SetVoltage(units::volt_t(0));
         state_ = STOPPED;
@@ -1754,7 +1798,7 @@ bool TwoJointArm::setElbowVolts(double volts)
     double theta = getTheta();
     double phi = getPhi();
     std::pair<double, double> xy = ArmKinematics::angToXY(theta, phi);
-    if (elbowMaster_.GetSupplyCurrent() > TwoJointArmConstants::STALL_SAFETY)
+    if (sample_.elbowCurrent > TwoJointArmConstants::STALL_SAFETY)
     {
         shoulderMaster_.SetVoltage(units::volt_t(0));
         elbowMaster_.SetVoltage(units::volt_t(0));
@@ -1823,7 +1867,7 @@ double TwoJointArm::getTheta()
     // return shoulderMaster_.GetSelectedSensorPosition(); //HERE
     //  double theta = shoulderMaster_.GetSelectedSensorPosition() / 2048 * 360 * TwoJointArmConstants::MOTOR_TO_SHOULDER_RATIO;
     //  double theta = shoulderEncoder_.GetAbsolutePosition();
-    double theta = -(shoulderEncoder_.GetAbsolutePosition() * 360.0) + TwoJointArmConstants::SHOULDER_ENCODER_OFFSET;
+    double theta = -(sample_.shoulderEncoderPos * 360.0) + TwoJointArmConstants::SHOULDER_ENCODER_OFFSET;
 
     // frc::SmartDashboard::PutNumber("GetSC", shoulderEncoder_.GetSourceChannel());
     // frc::SmartDashboard::PutNumber("GetAP", shoulderEncoder_.GetAbsolutePosition());
@@ -1839,23 +1883,23 @@ double TwoJointArm::getPhi()
     // return elbowMaster_.GetSelectedSensorPosition(); //HERE
     if (forward_)
     {
-        return elbowMaster_.GetSelectedSensorPosition() / 2048 * 360 * TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO - (getTheta() * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
+        return sample_.elbowMotorPos / 2048 * 360 * TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO - (getTheta() * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
     }
     else
     {
-        return (360 - elbowMaster_.GetSelectedSensorPosition() / 2048 * 360 * TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO) - (getTheta() * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
+        return (360 - sample_.elbowMotorPos / 2048 * 360 * TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO) - (getTheta() * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
     }
 }
 
 double TwoJointArm::getThetaVel()
 {
-    double vel = shoulderMaster_.GetSelectedSensorVelocity() / 2048 * 10 * 360 * TwoJointArmConstants::MOTOR_TO_SHOULDER_RATIO;
+    double vel = sample_.shoulderMotorVel / 2048 * 10 * 360 * TwoJointArmConstants::MOTOR_TO_SHOULDER_RATIO;
     return (forward_) ? vel : -vel;
 }
 
 double TwoJointArm::getPhiVel()
 {
-    double vel = elbowMaster_.GetSelectedSensorVelocity() / 2048 * 10 * 360 * TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO - (getThetaVel() * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
+    double vel = sample_.elbowMotorVel / 2048 * 10 * 360 * TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO - (getThetaVel() * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
     return (forward_) ? vel : -vel;
 }
 
@@ -1959,7 +2003,7 @@ void TwoJointArm::checkPos()
     }
 }
 
-std::string TwoJointArm::getStateString()
+const char *TwoJointArm::getStateString()
 {
     switch (state_)
     {
@@ -2001,7 +2045,7 @@ std::string TwoJointArm::getStateString()
     }
 }
 
-std::string TwoJointArm::getPosString()
+const char *TwoJointArm::getPosString()
 {
     switch (position_)
     {
@@ -2056,7 +2100,7 @@ std::string TwoJointArm::getPosString()
     }
 }
 
-std::string TwoJointArm::getSetPosString()
+const char *TwoJointArm::getSetPosString()
 {
     switch (setPosition_)
     {
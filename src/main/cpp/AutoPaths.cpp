@@ -27,6 +27,42 @@ AutoPaths::AutoPaths(SwerveDrive *swerveDrive, TwoJointArm *arm) : swerveDrive_(
     sendingIt_ = false;
     hitChargeStation_ = false;
     firstCubeArmSafety_ = false;
+    dockTilt_ = 0;
+    sendingItFast_ = false;
+    sendingItMedium_ = false;
+    balanced_ = false;
+    dumbStartTime_ = 0;
+    pathStartTime_ = 0;
+    pathClockUpdate_ = -1;
+
+    // Everything the drive follows runs on the path clock, so it all slows down together
+    xTraj_.setClock(&pathClock_);
+    yTraj_.setClock(&pathClock_);
+    yawTraj_.setClock(&pathClock_);
+    xSlowTraj_.setClock(&pathClock_);
+    ySlowTraj_.setClock(&pathClock_);
+}
+
+void AutoPaths::registerTelemetry(Telemetry &telemetry)
+{
+    actionNumChannel_ = telemetry.addInteger("action num");
+    pointNumChannel_ = telemetry.addInteger("point num");
+    dockTiltChannel_ = telemetry.addDouble("DTilt");
+    hitChargeStationChannel_ = telemetry.addBoolean("Hit Charge Station");
+    sendingItFastChannel_ = telemetry.addBoolean("Sending it Fast");
+    sendingItMediumChannel_ = telemetry.addBoolean("Sending it Medium");
+    balancedChannel_ = telemetry.addBoolean("Balanced");
+}
+
+void AutoPaths::logTelemetry(Telemetry &telemetry)
+{
+    telemetry.log(actionNumChannel_, actionNum_);
+    telemetry.log(pointNumChannel_, pointNum_);
+    telemetry.log(dockTiltChannel_, dockTilt_);
+    telemetry.log(hitChargeStationChannel_, hitChargeStation_);
+    telemetry.log(sendingItFastChannel_, sendingItFast_);
+    telemetry.log(sendingItMediumChannel_, sendingItMedium_);
+    telemetry.log(balancedChannel_, balanced_);
 }
 
 void AutoPaths::setPath(Path path)
@@ -852,12 +888,25 @@ void AutoPaths::setActions(Path a1, Path a2, Path a3, Path a4)
 
 void AutoPaths::startTimer()
 {
-    startTime_ = timer_.GetFPGATimestamp().value();
+    startTime_ = Clock::getDefault().getTime();
+    pathStartTime_ = pathClock_.getTime();
+}
+
+/*
+ * Moves the path clock along by how long it's been, times how much of the path the drive could keep up with
+ */
+void AutoPaths::updatePathClock(double time)
+{
+    if (pathClockUpdate_ >= 0)
+    {
+        pathClock_.setTime(pathClock_.getTime() + (time - pathClockUpdate_) * swerveDrive_->getPathTimeScale());
+    }
+    pathClockUpdate_ = time;
 }
 
 void AutoPaths::startAutoTimer()
 {
-    autoStartTime_ = timer_.GetFPGATimestamp().value();
+    autoStartTime_ = Clock::getDefault().getTime();
 }
 
 void AutoPaths::setActionsSet(bool actionsSet)
@@ -872,6 +921,8 @@ void AutoPaths::setPathSet(bool pathSet)
 
 void AutoPaths::periodic()
 {
+    updatePathClock(Clock::getDefault().getTime());
+
     if (!actionsSet_)
     {
         return;
@@ -890,10 +941,8 @@ void AutoPaths::periodic()
 
     // frc::SmartDashboard::PutBoolean("actions set", actionsSet_);
     // frc::SmartDashboard::PutBoolean("path set", pathSet_);
-    frc::SmartDashboard::PutNumber("action num", actionNum_);
-    frc::SmartDashboard::PutNumber("point num", pointNum_);
 
-    double time = timer_.GetFPGATimestamp().value() - startTime_;
+    double time = pathClock_.getTime() - pathStartTime_;
     // frc::SmartDashboard::PutNumber("time", time);
 
     bool pathOver = false;
@@ -927,7 +976,7 @@ void AutoPaths::periodic()
                         double setX = swervePoints_[i].getX();
                         // xTraj_.generateTrajectory(currPose.getX(), setX, swerveDrive_->getXYVel().first);
                         generateXTraj(currPose.getX(), setX, swerveDrive_->getXYVel().first);
-                        curveSecondStageStartTime_ = timer_.GetFPGATimestamp().value();
+                        curveSecondStageStartTime_ = Clock::getDefault().getTime();
 
                         curveSecondStageGenerated_ = false;
                         pathGenerated_ = true;
@@ -1017,7 +1066,7 @@ void AutoPaths::periodic()
                         }
                     }
 
-                    if ((!curveSecondStageGenerated_) && (/*pointNum_ == 1 || */ (pointNum_ == 0 && curveReady && timer_.GetFPGATimestamp().value() - curveSecondStageStartTime_ > 1.5 && get<0>(yProfile) == 0 && get<1>(yProfile) == 0)))
+                    if ((!curveSecondStageGenerated_) && (/*pointNum_ == 1 || */ (pointNum_ == 0 && curveReady && Clock::getDefault().getTime() - curveSecondStageStartTime_ > 1.5 && get<0>(yProfile) == 0 && get<1>(yProfile) == 0)))
                     {
                         double setY = swervePoints_[i].getY();
                         // yTraj_.generateTrajectory(swerveDrive_->getY(), setY, swerveDrive_->getXYVel().second);
@@ -1054,7 +1103,7 @@ void AutoPaths::periodic()
                         double setX = swervePoints_[i].getX();
                         // xTraj_.generateTrajectory(currPose.getX(), setX, swerveDrive_->getXYVel().first);
                         generateXTraj(currPose.getX(), setX, swerveDrive_->getXYVel().first);
-                        curveSecondStageStartTime_ = timer_.GetFPGATimestamp().value();
+                        curveSecondStageStartTime_ = Clock::getDefault().getTime();
 
                         curveSecondStageGenerated_ = false;
                         pathGenerated_ = true;
@@ -1156,7 +1205,7 @@ void AutoPaths::periodic()
                         double setY = swervePoints_[i].getY();
                         // yTraj_.generateTrajectory(currPose.getY(), setY, swerveDrive_->getXYVel().second);
                         generateYTraj(currPose.getY(), setY, swerveDrive_->getXYVel().second);
-                        curveSecondStageStartTime_ = timer_.GetFPGATimestamp().value();
+                        curveSecondStageStartTime_ = Clock::getDefault().getTime();
                         yawStageGenerated_ = true;
 
                         double setYaw = swervePoints_[i].getYaw();
@@ -1166,7 +1215,7 @@ void AutoPaths::periodic()
                         pathGenerated_ = true;
                     }
 
-                    if ((!curveSecondStageGenerated_) && timer_.GetFPGATimestamp().value() - curveSecondStageStartTime_ > 1.2)
+                    if ((!curveSecondStageGenerated_) && Clock::getDefault().getTime() - curveSecondStageStartTime_ > 1.2)
                     {
                         double setX = swervePoints_[i].getX();
                         // xTraj_.generateTrajectory(swerveDrive_->getX(), setX, swerveDrive_->getXYVel().first);
@@ -1185,7 +1234,7 @@ void AutoPaths::periodic()
                         double setY = swervePoints_[i].getY();
                         // yTraj_.generateTrajectory(currPose.getY(), setY, swerveDrive_->getXYVel().second);
                         generateYTraj(currPose.getY(), setY, swerveDrive_->getXYVel().second);
-                        curveSecondStageStartTime_ = timer_.GetFPGATimestamp().value();
+                        curveSecondStageStartTime_ = Clock::getDefault().getTime();
 
                         double setYaw = swervePoints_[i].getYaw();
                         yawTraj_.generateTrajectory(currPose.getYaw(), setYaw, 0); // TODO yaw vel
@@ -1194,7 +1243,7 @@ void AutoPaths::periodic()
                         pathGenerated_ = true;
                     }
 
-                    if ((!curveSecondStageGenerated_) && timer_.GetFPGATimestamp().value() - curveSecondStageStartTime_ > 1)
+                    if ((!curveSecondStageGenerated_) && Clock::getDefault().getTime() - curveSecondStageStartTime_ > 1)
                     {
                         double setX = swervePoints_[i].getX();
                         // xTraj_.generateTrajectory(swerveDrive_->getX(), setX, swerveDrive_->getXYVel().first);
@@ -1211,7 +1260,7 @@ void AutoPaths::periodic()
                             double setX = swervePoints_[i].getX();
                             // xTraj_.generateTrajectory(currPose.getX(), setX, swerveDrive_->getXYVel().first);
                             generateXTraj(currPose.getX(), setX, swerveDrive_->getXYVel().first);
-                            curveSecondStageStartTime_ = timer_.GetFPGATimestamp().value();
+                            curveSecondStageStartTime_ = Clock::getDefault().getTime();
 
                             // double setYaw = swervePoints_[i].getYaw();
                             // yawTraj_.generateTrajectory(currPose.getYaw(), setYaw, 0); // TODO yaw vel
@@ -1260,7 +1309,7 @@ void AutoPaths::periodic()
 
                         // frc::SmartDashboard::PutBoolean("GEN", curveSecondStageGenerated_);
                         // frc::SmartDashboard::PutBoolean("PATH", pathGenerated_);
-                        // frc::SmartDashboard::PutNumber("TIME", timer_.GetFPGATimestamp().value() - curveSecondStageStartTime_);
+                        // frc::SmartDashboard::PutNumber("TIME", Clock::getDefault().getTime() - curveSecondStageStartTime_);
                         // tuple<double, double, double> yProfile = yTraj_.getProfile();
                         tuple<double, double, double> yProfile = getYProfile();
 
@@ -1273,7 +1322,7 @@ void AutoPaths::periodic()
                         {
                             curveReady = (swerveDrive_->getX() < 11.688318); // 13.621893
                         }
-                        if ((!curveSecondStageGenerated_) /* && timer_.GetFPGATimestamp().value() - curveSecondStageStartTime_ > 1.5*/ && curveReady && get<0>(yProfile) == 0 && get<1>(yProfile) == 0)
+                        if ((!curveSecondStageGenerated_) /* && Clock::getDefault().getTime() - curveSecondStageStartTime_ > 1.5*/ && curveReady && get<0>(yProfile) == 0 && get<1>(yProfile) == 0)
                         {
                             double setY = swervePoints_[i].getY();
                             // yTraj_.generateTrajectory(swerveDrive_->getY(), setY, swerveDrive_->getXYVel().second);
@@ -1452,7 +1501,7 @@ void AutoPaths::periodic()
                     double pitch = Helpers::getPrincipalAng2Deg(pitch_ + SwerveConstants::PITCHOFFSET); // Degrees
                     double roll = Helpers::getPrincipalAng2Deg(roll_ + SwerveConstants::ROLLOFFSET);    // Degrees
                     double tilt = pitch * sin(ang) - roll * cos(ang);
-                    frc::SmartDashboard::PutNumber("DTilt", tilt);
+                    dockTilt_ = tilt;
                     if (frc::DriverStation::GetAlliance() == frc::DriverStation::kBlue)
                     {
                         if (tilt > 5)
@@ -1472,13 +1521,8 @@ void AutoPaths::periodic()
                         }
                     }
 
-                    frc::SmartDashboard::PutBoolean("Hit Charge Station", false);
-                    frc::SmartDashboard::PutBoolean("Sending it Fast", false);
-                    frc::SmartDashboard::PutBoolean("Sending it Medium", false);
-                }
-                else
-                {
-                    frc::SmartDashboard::PutBoolean("Hit Charge Station", true);
+                    sendingItFast_ = false;
+                    sendingItMedium_ = false;
                 }
             }
             else if ((path_ == FIRST_CONE_DOCK && pointNum_ == 1) || (path_ == FIRST_CUBE_DOCK && pointNum_ == 1))
@@ -1535,7 +1579,7 @@ void AutoPaths::periodic()
                     pathGenerated_ = false;
                     curveSecondStageGenerated_ = false;
                     yawStageGenerated_ = false;
-                    time = timer_.GetFPGATimestamp().value() - startTime_;
+                    time = pathClock_.getTime() - pathStartTime_;
                 }
                 else
                 {
@@ -1546,7 +1590,7 @@ void AutoPaths::periodic()
 
         if (pose != nullptr)
         {
-            if (timer_.GetFPGATimestamp().value() - autoStartTime_ > 14.9 && (path_ == SECOND_CUBE_DOCK || path_ == FIRST_CUBE_DOCK || path_ == SECOND_CONE_DOCK || path_ == FIRST_CONE_DOCK || path_ == AUTO_DOCK))
+            if (Clock::getDefault().getTime() - autoStartTime_ > 14.9 && (path_ == SECOND_CUBE_DOCK || path_ == FIRST_CUBE_DOCK || path_ == SECOND_CONE_DOCK || path_ == FIRST_CONE_DOCK || path_ == AUTO_DOCK))
             {
                 swerveDrive_->lockWheels();
             }
@@ -1576,9 +1620,7 @@ void AutoPaths::periodic()
     {
         if (!dumbTimerStarted_)
         {
-            timer_.Stop();
-            timer_.Reset();
-            timer_.Start();
+            dumbStartTime_ = Clock::getDefault().getTime();
             dumbTimerStarted_ = true;
         }
     }
@@ -1668,16 +1710,16 @@ void AutoPaths::periodic()
             clawOpen_ = true;
             if (!placingTimerStarted_)
             {
-                placingStartTime_ = timer_.GetFPGATimestamp().value();
+                placingStartTime_ = Clock::getDefault().getTime();
                 placingTimerStarted_ = true;
             }
 
-            // if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.2)
+            // if (Clock::getDefault().getTime() - placingStartTime_ > 0.2)
             // {
             //     clawOpen_ = true;
             // }
 
-            if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.3)
+            if (Clock::getDefault().getTime() - placingStartTime_ > 0.3)
             {
                 // pointOver = true;
                 clawOpen_ = true;
@@ -1703,11 +1745,11 @@ void AutoPaths::periodic()
             wheelSpeed_ = ClawConstants::OUTAKING_SPEED;
             if (!placingTimerStarted_)
             {
-                placingStartTime_ = timer_.GetFPGATimestamp().value();
+                placingStartTime_ = Clock::getDefault().getTime();
                 placingTimerStarted_ = true;
             }
 
-            if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.4)
+            if (Clock::getDefault().getTime() - placingStartTime_ > 0.4)
             {
                 pointOver = true;
                 nextPointReady_ = true;
@@ -1735,16 +1777,16 @@ void AutoPaths::periodic()
             clawOpen_ = true;
             if (!placingTimerStarted_)
             {
-                placingStartTime_ = timer_.GetFPGATimestamp().value();
+                placingStartTime_ = Clock::getDefault().getTime();
                 placingTimerStarted_ = true;
             }
 
-            // if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.2)
+            // if (Clock::getDefault().getTime() - placingStartTime_ > 0.2)
             // {
             //     clawOpen_ = true;
             // }
 
-            if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.3)
+            if (Clock::getDefault().getTime() - placingStartTime_ > 0.3)
             {
                 // pointOver = true;
                 clawOpen_ = true;
@@ -1770,11 +1812,11 @@ void AutoPaths::periodic()
             wheelSpeed_ = ClawConstants::OUTAKING_SPEED;
             if (!placingTimerStarted_)
             {
-                placingStartTime_ = timer_.GetFPGATimestamp().value();
+                placingStartTime_ = Clock::getDefault().getTime();
                 placingTimerStarted_ = true;
             }
 
-            if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.4)
+            if (Clock::getDefault().getTime() - placingStartTime_ > 0.4)
             {
                 pointOver = true;
                 nextPointReady_ = true;
@@ -1802,16 +1844,16 @@ void AutoPaths::periodic()
             clawOpen_ = true;
             if (!placingTimerStarted_)
             {
-                placingStartTime_ = timer_.GetFPGATimestamp().value();
+                placingStartTime_ = Clock::getDefault().getTime();
                 placingTimerStarted_ = true;
             }
 
-            // if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.2)
+            // if (Clock::getDefault().getTime() - placingStartTime_ > 0.2)
             // {
             //     clawOpen_ = true;
             // }
 
-            if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.3)
+            if (Clock::getDefault().getTime() - placingStartTime_ > 0.3)
             {
                 // pointOver = true;
                 clawOpen_ = true;
@@ -1840,16 +1882,16 @@ void AutoPaths::periodic()
             clawOpen_ = true;
             if (!placingTimerStarted_)
             {
-                placingStartTime_ = timer_.GetFPGATimestamp().value();
+                placingStartTime_ = Clock::getDefault().getTime();
                 placingTimerStarted_ = true;
             }
 
-            // if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.2)
+            // if (Clock::getDefault().getTime() - placingStartTime_ > 0.2)
             // {
             //     clawOpen_ = true;
             // }
 
-            if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.3)
+            if (Clock::getDefault().getTime() - placingStartTime_ > 0.3)
             {
                 // pointOver = true;
                 clawOpen_ = true;
@@ -1909,7 +1951,7 @@ void AutoPaths::periodic()
                 {
                     armReady = (swerveDrive_->getX() > 13.621893 + 0.2);
                 }
-                if (timer_.GetFPGATimestamp().value() - startTime_ > 0.2 && !armReady)
+                if (Clock::getDefault().getTime() - startTime_ > 0.2 && !armReady)
                 {
                     cubeIntaking_ = false;
                     forward_ = false; // SAFETY WAS TRUE
@@ -1921,7 +1963,7 @@ void AutoPaths::periodic()
                     // }
                     // }
                 }
-                else if (timer_.GetFPGATimestamp().value() - startTime_ > 0.2 && armReady)
+                else if (Clock::getDefault().getTime() - startTime_ > 0.2 && armReady)
                 {
                     cubeIntaking_ = false;
                     forward_ = true;
@@ -1936,7 +1978,7 @@ void AutoPaths::periodic()
             }
             else
             {
-                if (timer_.GetFPGATimestamp().value() - startTime_ > 0.2)
+                if (Clock::getDefault().getTime() - startTime_ > 0.2)
                 {
                     cubeIntaking_ = false;
                     forward_ = true;
@@ -1955,11 +1997,11 @@ void AutoPaths::periodic()
                 wheelSpeed_ = ClawConstants::OUTAKING_SPEED;
                 if (!placingTimerStarted_)
                 {
-                    placingStartTime_ = timer_.GetFPGATimestamp().value();
+                    placingStartTime_ = Clock::getDefault().getTime();
                     placingTimerStarted_ = true;
                 }
 
-                if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.4)
+                if (Clock::getDefault().getTime() - placingStartTime_ > 0.4)
                 {
                     nextPointReady_ = true;
                     placingTimerStarted_ = false;
@@ -1990,13 +2032,13 @@ void AutoPaths::periodic()
         {
             wheelSpeed_ = ClawConstants::INTAKING_SPEED;
             clawOpen_ = true;
-            if (timer_.GetFPGATimestamp().value() - startTime_ > 0.2)
+            if (Clock::getDefault().getTime() - startTime_ > 0.2)
             {
                 cubeIntaking_ = false;
                 forward_ = false;
             }
 
-            if (pointOver && timer_.GetFPGATimestamp().value() - autoStartTime_ < 14.9)
+            if (pointOver && Clock::getDefault().getTime() - autoStartTime_ < 14.9)
             {
                 double ang = (yaw_)*M_PI / 180.0;                                                   // Radians
                 double pitch = Helpers::getPrincipalAng2Deg(pitch_ + SwerveConstants::PITCHOFFSET); // Degrees
@@ -2056,7 +2098,7 @@ void AutoPaths::periodic()
             {
                 armReady = (swerveDrive_->getX() > 13.621893 + 0.2);
             }
-            if (timer_.GetFPGATimestamp().value() - startTime_ > 0.2 && !armReady)
+            if (Clock::getDefault().getTime() - startTime_ > 0.2 && !armReady)
             {
                 cubeIntaking_ = false;
                 forward_ = false; // SAFETY WAS TRUE
@@ -2068,7 +2110,7 @@ void AutoPaths::periodic()
                 // }
                 // }
             }
-            else if (timer_.GetFPGATimestamp().value() - startTime_ > 0.2 && armReady)
+            else if (Clock::getDefault().getTime() - startTime_ > 0.2 && armReady)
             {
                 cubeIntaking_ = false;
                 forward_ = true;
@@ -2086,11 +2128,11 @@ void AutoPaths::periodic()
                 wheelSpeed_ = ClawConstants::OUTAKING_SPEED - 3;
                 if (!placingTimerStarted_)
                 {
-                    placingStartTime_ = timer_.GetFPGATimestamp().value();
+                    placingStartTime_ = Clock::getDefault().getTime();
                     placingTimerStarted_ = true;
                 }
 
-                if (timer_.GetFPGATimestamp().value() - placingStartTime_ > 0.4)
+                if (Clock::getDefault().getTime() - placingStartTime_ > 0.4)
                 {
                     nextPointReady_ = true;
                     placingTimerStarted_ = false;
@@ -2140,21 +2182,21 @@ void AutoPaths::periodic()
         {
             wheelSpeed_ = ClawConstants::INTAKING_SPEED;
             clawOpen_ = true;
-            if (timer_.GetFPGATimestamp().value() - startTime_ > 0.2)
+            if (Clock::getDefault().getTime() - startTime_ > 0.2)
             {
                 cubeIntaking_ = false;
                 forward_ = false;
                 armPosition_ = TwoJointArmProfiles::STOWED;
             }
 
-            if (hitChargeStation_ && timer_.GetFPGATimestamp().value() - autoStartTime_ < 14.9)
+            if (hitChargeStation_ && Clock::getDefault().getTime() - autoStartTime_ < 14.9)
             {
                 if (!sendingIt_)
                 {
-                    sendingItTime_ = timer_.GetFPGATimestamp().value();
+                    sendingItTime_ = Clock::getDefault().getTime();
                     sendingIt_ = true;
                 }
-                double time = timer_.GetFPGATimestamp().value() - sendingItTime_;
+                double time = Clock::getDefault().getTime() - sendingItTime_;
                 if (time < SwerveConstants::SENDING_IT_TIME)
                 {
                     double ang = (yaw_)*M_PI / 180.0;                                                   // Radians
@@ -2165,14 +2207,14 @@ void AutoPaths::periodic()
                     {
                         if (abs(tilt) < SwerveConstants::MIN_TILT_ON_STATION)
                         {
-                            frc::SmartDashboard::PutBoolean("Sending it Fast", true);
-                            frc::SmartDashboard::PutBoolean("Sending it Medium", false);
+                            sendingItFast_ = true;
+                            sendingItMedium_ = false;
                             swerveDrive_->drive(-SwerveConstants::SENDING_IT_FAST_SPEED, 0, 0);
                         }
                         else
                         {
-                            frc::SmartDashboard::PutBoolean("Sending it Fast", false);
-                            frc::SmartDashboard::PutBoolean("Sending it Medium", true);
+                            sendingItFast_ = false;
+                            sendingItMedium_ = true;
                             swerveDrive_->drive(-SwerveConstants::SENDING_IT_MED_SPEED, 0, 0);
                         }
                     }
@@ -2180,40 +2222,40 @@ void AutoPaths::periodic()
                     {
                         if (abs(tilt) < SwerveConstants::MIN_TILT_ON_STATION)
                         {
-                            frc::SmartDashboard::PutBoolean("Sending it Fast", true);
-                            frc::SmartDashboard::PutBoolean("Sending it Medium", false);
+                            sendingItFast_ = true;
+                            sendingItMedium_ = false;
                             swerveDrive_->drive(SwerveConstants::SENDING_IT_FAST_SPEED, 0, 0);
                         }
                         else
                         {
-                            frc::SmartDashboard::PutBoolean("Sending it Fast", false);
-                            frc::SmartDashboard::PutBoolean("Sending it Medium", true);
+                            sendingItFast_ = false;
+                            sendingItMedium_ = true;
                             swerveDrive_->drive(SwerveConstants::SENDING_IT_MED_SPEED, 0, 0);
                         }
                     }
                 }
                 else
                 {
-                    frc::SmartDashboard::PutBoolean("Sending it Fast", false);
-                    frc::SmartDashboard::PutBoolean("Sending it Medium", false);
+                    sendingItFast_ = false;
+                    sendingItMedium_ = false;
                     double ang = (yaw_)*M_PI / 180.0;                                                   // Radians
                     double pitch = Helpers::getPrincipalAng2Deg(pitch_ + SwerveConstants::PITCHOFFSET); // Degrees
                     double roll = Helpers::getPrincipalAng2Deg(roll_ + SwerveConstants::ROLLOFFSET);    // Degrees
                     double tilt = pitch * sin(ang) - roll * cos(ang);
                     if (abs(tilt) < SwerveConstants::AUTODEADANGLE)
                     {
-                        frc::SmartDashboard::PutBoolean("Balanced", true);
+                        balanced_ = true;
                         swerveDrive_->lockWheels();
                     }
                     else
                     {
-                        frc::SmartDashboard::PutBoolean("Balanced", false);
+                        balanced_ = false;
                         double output = -SwerveConstants::AUTOKTILT * tilt;
                         swerveDrive_->drive(output, 0, 0);
                     }
                 }
             }
-            else if(timer_.GetFPGATimestamp().value() - autoStartTime_ > 14.9)
+            else if(Clock::getDefault().getTime() - autoStartTime_ > 14.9)
             {
                 swerveDrive_->lockWheels();
             }
@@ -2223,7 +2265,7 @@ void AutoPaths::periodic()
     }
     case SECOND_CUBE_GRAB:
     {
-        if (timer_.GetFPGATimestamp().value() - autoStartTime_ < 15.0 - 1.126)
+        if (Clock::getDefault().getTime() - autoStartTime_ < 15.0 - 1.126)
         {
             armPosition_ = TwoJointArmProfiles::CUBE_INTAKE;
             forward_ = false;
@@ -2246,14 +2288,14 @@ void AutoPaths::periodic()
         armPosition_ = TwoJointArmProfiles::STOWED;
         clawOpen_ = false;
         wheelSpeed_ = 0;
-        if (hitChargeStation_ && timer_.GetFPGATimestamp().value() - autoStartTime_ < 14.9)
+        if (hitChargeStation_ && Clock::getDefault().getTime() - autoStartTime_ < 14.9)
         {
             if (!sendingIt_)
             {
-                sendingItTime_ = timer_.GetFPGATimestamp().value();
+                sendingItTime_ = Clock::getDefault().getTime();
                 sendingIt_ = true;
             }
-            double time = timer_.GetFPGATimestamp().value() - sendingItTime_;
+            double time = Clock::getDefault().getTime() - sendingItTime_;
             if (time < SwerveConstants::SENDING_IT_TIME)
             {
                 double ang = (yaw_)*M_PI / 180.0;                                                   // Radians
@@ -2413,7 +2455,7 @@ void AutoPaths::periodic()
         //     swerveDrive_->drive(0, 0, 0);
         // }
 
-        if (timer_.Get().value() < 2)
+        if (Clock::getDefault().getTime() - dumbStartTime_ < 2)
         {
             if (frc::DriverStation::GetAlliance() == frc::DriverStation::kBlue)
             {
@@ -1,5 +1,7 @@
 #include "Drivebase/SwerveDrive.h"
 
+#include <algorithm>
+
 /*
  * Constructor
  */
@@ -19,6 +21,15 @@ SwerveDrive::SwerveDrive()
     xLineupTrim_ = 0;
     yLineupTrim_ = 0;
     numLargeDiffs_ = 0;
+    tagWantedX_ = 0;
+    tagWantedY_ = 0;
+    tagWantedYaw_ = 0;
+    tagFieldX_ = 0;
+    tagFieldY_ = 0;
+    differentTag_ = false;
+    prevTime_ = -1;
+    yaw_ = 0;
+    yawVel_ = 0;
     // inching_ = false;
 
     // aprilTagX_ = 0;
@@ -27,6 +38,55 @@ SwerveDrive::SwerveDrive()
     // yawTagOffset_ = 0;
 }
 
+/*
+ * Reads every module's sensors once for this loop
+ */
+SwerveDrive::Sample SwerveDrive::sample()
+{
+    return {topRight_->sample(), topLeft_->sample(), bottomRight_->sample(), bottomLeft_->sample()};
+}
+
+void SwerveDrive::registerTelemetry(Telemetry &telemetry)
+{
+    xTrimChannel_ = telemetry.addDouble("X Trim");
+    yTrimChannel_ = telemetry.addDouble("Y Trim");
+    tagWantedXChannel_ = telemetry.addDouble("WX");
+    tagWantedYChannel_ = telemetry.addDouble("WY");
+    tagFieldXChannel_ = telemetry.addDouble("AT X");
+    tagFieldYChannel_ = telemetry.addDouble("AT Y");
+    differentTagChannel_ = telemetry.addBoolean("Different Tag");
+    translationScaleChannel_ = telemetry.addDouble("Translation Scale");
+    turnScaleChannel_ = telemetry.addDouble("Turn Scale");
+    pathTimeScaleChannel_ = telemetry.addDouble("Path Time Scale");
+
+    topRight_->registerTelemetry(telemetry);
+    topLeft_->registerTelemetry(telemetry);
+    bottomRight_->registerTelemetry(telemetry);
+    bottomLeft_->registerTelemetry(telemetry);
+}
+
+/*
+ * Logs the lineup state and the CAN health of every module, the robot calls this at the slow rate
+ */
+void SwerveDrive::logTelemetry(Telemetry &telemetry)
+{
+    telemetry.log(xTrimChannel_, xLineupTrim_ / 0.0254);
+    telemetry.log(yTrimChannel_, yLineupTrim_ / 0.0254);
+    telemetry.log(tagWantedXChannel_, tagWantedX_);
+    telemetry.log(tagWantedYChannel_, tagWantedY_);
+    telemetry.log(tagFieldXChannel_, tagFieldX_);
+    telemetry.log(tagFieldYChannel_, tagFieldY_);
+    telemetry.log(differentTagChannel_, differentTag_);
+    telemetry.log(translationScaleChannel_, translationScale_);
+    telemetry.log(turnScaleChannel_, turnScale_);
+    telemetry.log(pathTimeScaleChannel_, pathTimeScale_);
+
+    topRight_->logTelemetry(telemetry);
+    topLeft_->logTelemetry(telemetry);
+    bottomRight_->logTelemetry(telemetry);
+    bottomLeft_->logTelemetry(telemetry);
+}
+
 /*
  * Setter for yaw, i.e. the angle of the robot
  *
@@ -37,17 +97,55 @@ void SwerveDrive::setYaw(double yaw)
     yaw_ = yaw;
 }
 
-void SwerveDrive::periodic(double yaw, double tilt, vector<double> data)
+/*
+ * @param time The loop's timestamp in seconds, from the robot snapshot
+ */
+void SwerveDrive::periodic(double yaw, double tilt, vector<double> data, double time)
+{
+    updateOdometry(yaw, time);
+    updateVision(tilt, data, time);
+    updateModules(time);
+}
+
+/*
+ * Integrates the module velocities, run at the fast rate so the pose history has an entry close to every camera frame
+ */
+void SwerveDrive::updateOdometry(double yaw, double time)
 {
+    bool first = prevTime_ < 0;
+    double yawDelta = yaw - yaw_;
+    if (abs(yawDelta) > 180)
+    {
+        yawDelta -= (yawDelta > 0) ? 360 : -360;
+    }
+
     setYaw(yaw);
-    calcOdometry();
-    updateAprilTagFieldXY(tilt, data);
+    calcOdometry(time);
+    yawVel_ = first ? 0 : yawDelta / dT_;
+}
+
+/*
+ * Fuses the latest april tag detection into the pose
+ */
+void SwerveDrive::updateVision(double tilt, vector<double> data, double time)
+{
+    updateAprilTagFieldXY(tilt, data, time);
+}
+
+/*
+ * Runs every module's steering loop towards the last setpoint, at the fast rate
+ */
+void SwerveDrive::updateModules(double time)
+{
+    topRight_->update(time);
+    topLeft_->update(time);
+    bottomRight_->update(time);
+    bottomLeft_->update(time);
 }
 
 void SwerveDrive::teleopPeriodic(Controls *controls, bool forward, bool panic, int scoringLevel)
 {
     // frc::SmartDashboard::PutBoolean("Found Tag", foundTag_);
-    frc::SmartDashboard::PutNumber("STime", timer_.GetFPGATimestamp().value());
 
     if (controls->lineupTrimXUpPressed())
     {
@@ -98,8 +196,6 @@ void SwerveDrive::teleopPeriodic(Controls *controls, bool forward, bool panic, i
         yLineupTrim_ -= 0.0254;
     }
 
-    frc::SmartDashboard::PutNumber("X Trim", xLineupTrim_ / 0.0254);
-    frc::SmartDashboard::PutNumber("Y Trim", yLineupTrim_ / 0.0254);
 
     // frc::SmartDashboard::PutBoolean("LJT", controls->lJoyTriggerDown());
     if (controls->lJoyTriggerDown())
@@ -289,14 +385,30 @@ void SwerveDrive::teleopPeriodic(Controls *controls, bool forward, bool panic, i
             //     }
             // }
 
-            frc::SmartDashboard::PutNumber("WX", wantedX);
-            frc::SmartDashboard::PutNumber("WY", wantedY);
-            xTagTraj_.generateTrajectory(robotX_, wantedX, (getXYVel().first));
-            yTagTraj_.generateTrajectory(robotY_, wantedY, (getXYVel().second));
-            yawTagTraj_.generateTrajectory(yaw_, wantedYaw, 0);
+            tagWantedX_ = wantedX;
+            tagWantedY_ = wantedY;
+            tagWantedYaw_ = wantedYaw;
+            pair<double, double> xyVel = getXYVel();
+            // Driver has x at the player station, only line up y and yaw, leaving their x speed out so it isn't braked
+            // on the across axis and taking the limit from y
+            tagLineup_.generate(robotX_, robotY_, yaw_, playerStation ? 0 : xyVel.first, xyVel.second, 0, playerStation ? robotX_ : wantedX, wantedY, wantedYaw);
 
             trackingTag_ = true;
         }
+        else if (!trackingPlayerStation_)
+        {
+            // Vision (or the trims) moved the target, carry on from the setpoint to the new one
+            pair<double, double> scoringPos = checkScoringPos(scoringLevel);
+            if (scoringPos.first != 0 || scoringPos.second != 0)
+            {
+                double wantedY = scoringPos.second + ((tagWantedYaw_ > 0) ? -SwerveConstants::CLAW_MID_OFFSET : SwerveConstants::CLAW_MID_OFFSET);
+                if (tagLineup_.replan(scoringPos.first, wantedY, tagWantedYaw_, SwerveConstants::LINEUP_REPLAN_DIST))
+                {
+                    tagWantedX_ = scoringPos.first;
+                    tagWantedY_ = wantedY;
+                }
+            }
+        }
 
         // bool end = false;
         // double time = timer_.GetFPGATimestamp().value() - tagFollowingStartTime_;
@@ -318,9 +430,7 @@ void SwerveDrive::teleopPeriodic(Controls *controls, bool forward, bool panic, i
         // }
         // delete wantedPose;
 
-        tuple<double, double, double> xProfile = xTagTraj_.getProfile();
-        tuple<double, double, double> yProfile = yTagTraj_.getProfile();
-        tuple<double, double, double> yawProfile = yawTagTraj_.getProfile();
+        SwervePose lineupPose = tagLineup_.getPose();
 
         if (trackingPlayerStation_)
         {
@@ -342,7 +452,7 @@ void SwerveDrive::teleopPeriodic(Controls *controls, bool forward, bool panic, i
             {
                 xStrafe = -controls->getYStrafe() * SwerveConstants::MAX_TELE_VEL;
             }
-            SwervePose *wantedPose = new SwervePose(getX(), get<2>(yProfile), get<2>(yawProfile), xStrafe, get<1>(yProfile), get<1>(yawProfile), 0, get<0>(yProfile), get<0>(yawProfile));
+            SwervePose *wantedPose = new SwervePose(getX(), lineupPose.getY(), lineupPose.getYaw(), xStrafe, lineupPose.getYVel(), lineupPose.getYawVel(), 0, lineupPose.getYAcc(), lineupPose.getYawAcc());
             // frc::SmartDashboard::PutNumber("WX", wantedPose->getX());
             // frc::SmartDashboard::PutNumber("WY", wantedPose->getY());
             // frc::SmartDashboard::PutNumber("WYAW", wantedPose->getYaw());
@@ -351,9 +461,9 @@ void SwerveDrive::teleopPeriodic(Controls *controls, bool forward, bool panic, i
         }
         else
         {
-            if (get<0>(xProfile) == 0 && get<0>(yProfile) == 0 && get<0>(yawProfile) == 0 && get<1>(xProfile) == 0 && get<1>(yProfile) == 0 && get<1>(yawProfile) == 0)
+            if (tagLineup_.isDone())
             {
-                if (abs(robotX_ - get<2>(xProfile)) > 0.08 || abs(robotY_ - get<2>(yProfile)) > 0.08)
+                if (abs(robotX_ - lineupPose.getX()) > 0.08 || abs(robotY_ - lineupPose.getY()) > 0.08)
                 {
                     trackingTag_ = false;
                     trackingPlayerStation_ = false;
@@ -361,12 +471,10 @@ void SwerveDrive::teleopPeriodic(Controls *controls, bool forward, bool panic, i
                 }
             }
 
-            SwervePose *wantedPose = new SwervePose(get<2>(xProfile), get<2>(yProfile), get<2>(yawProfile), get<1>(xProfile), get<1>(yProfile), get<1>(yawProfile), get<0>(xProfile), get<0>(yProfile), get<0>(yawProfile));
-            // frc::SmartDashboard::PutNumber("WX", wantedPose->getX());
-            // frc::SmartDashboard::PutNumber("WY", wantedPose->getY());
-            // frc::SmartDashboard::PutNumber("WYAW", wantedPose->getYaw());
-            drivePose(*wantedPose);
-            delete wantedPose;
+            // frc::SmartDashboard::PutNumber("WX", lineupPose.getX());
+            // frc::SmartDashboard::PutNumber("WY", lineupPose.getY());
+            // frc::SmartDashboard::PutNumber("WYAW", lineupPose.getYaw());
+            drivePose(lineupPose);
         }
     }
     else if (controls->lockWheels())
@@ -562,7 +670,7 @@ void SwerveDrive::drive(double xSpeed, double ySpeed, double turn)
         isHoldingYaw_ = false;
     }
 
-    calcModules(xSpeed, ySpeed, /*0, 0,*/ turn, /*0,*/ false);
+    calcModules(xSpeed, ySpeed, 0, 0, turn, 0, false);
 
     // double volts = frc::SmartDashboard::GetNumber("Swerve Volts", 0.0);
 
@@ -599,10 +707,10 @@ void SwerveDrive::drive(double xSpeed, double ySpeed, double turn)
     // 6, 9800, 178.7173
     // m = 0.0291946, b = 0.746574
 
-    topRight_->periodic(trSpeed_, trAngle_, false);
-    topLeft_->periodic(tlSpeed_, tlAngle_, false);
-    bottomRight_->periodic(brSpeed_, brAngle_, false);
-    bottomLeft_->periodic(blSpeed_, blAngle_, false);
+    topRight_->periodic(trSpeed_, trAngle_, trAcc_, trAngVel_);
+    topLeft_->periodic(tlSpeed_, tlAngle_, tlAcc_, tlAngVel_);
+    bottomRight_->periodic(brSpeed_, brAngle_, brAcc_, brAngVel_);
+    bottomLeft_->periodic(blSpeed_, blAngle_, blAcc_, blAngVel_);
 
     // double speed = frc::SmartDashboard::GetNumber("Swerve Volts", 0);
     // topRight_->periodic(speed, trAngle_, true);
@@ -622,17 +730,22 @@ void SwerveDrive::lockWheels()
     brAngle_ = 45;
     blAngle_ = 135;
 
-    topRight_->periodic(trSpeed_, trAngle_, false);
-    topLeft_->periodic(tlSpeed_, tlAngle_, false);
-    bottomRight_->periodic(brSpeed_, brAngle_, false);
-    bottomLeft_->periodic(blSpeed_, blAngle_, false);
+    topRight_->periodic(trSpeed_, trAngle_);
+    topLeft_->periodic(tlSpeed_, tlAngle_);
+    bottomRight_->periodic(brSpeed_, brAngle_);
+    bottomLeft_->periodic(blSpeed_, blAngle_);
 }
 
+/*
+ * Follows a pose sampled off a path at getPathTimeScale() times real time, so its velocities and accelerations get
+ * scaled down to match
+ */
 void SwerveDrive::drivePose(SwervePose pose)
 {
-    double xVel = pose.getXVel();
-    double yVel = pose.getYVel();
-    double yawVel = pose.getYawVel();
+    double scale = pathTimeScale_;
+    double xVel = pose.getXVel() * scale;
+    double yVel = pose.getYVel() * scale;
+    double yawVel = pose.getYawVel() * scale;
 
     // HERE
     //  setPos(pair<double, double>{pose.getX(), pose.getY()});
@@ -656,7 +769,8 @@ void SwerveDrive::drivePose(SwervePose pose)
         else
         {
             // normal x stuff and path still going
-            xVel += (pose.getX() - robotX_) * SwerveConstants::klP + (pose.getXVel() - getXYVel().first) * SwerveConstants::klD;
+            // the D term is against the slowed down path, what the drive could actually do, so it doesn't wind up while saturated
+            xVel += (pose.getX() - robotX_) * SwerveConstants::klP + (pose.getXVel() * scale - getXYVel().first) * SwerveConstants::klD;
         }
 
         if (pose.getYVel() == 0 && pose.getYAcc() == 0)
@@ -675,7 +789,7 @@ void SwerveDrive::drivePose(SwervePose pose)
         else
         {
             // normal y stuff and path still going
-            yVel += (pose.getY() - robotY_) * SwerveConstants::klP + (pose.getYVel() - getXYVel().second) * SwerveConstants::klD;
+            yVel += (pose.getY() - robotY_) * SwerveConstants::klP + (pose.getYVel() * scale - getXYVel().second) * SwerveConstants::klD;
         }
 
         if (pose.getYawVel() == 0 && pose.getYawAcc() == 0)
@@ -716,7 +830,7 @@ void SwerveDrive::drivePose(SwervePose pose)
                     yawError += 360;
                 }
             }
-            yawVel += (yawError)*SwerveConstants::kaP;
+            yawVel += (yawError)*SwerveConstants::kaP + (pose.getYawVel() * scale - yawVel_) * SwerveConstants::kaD;
         }
     }
 
@@ -728,13 +842,17 @@ void SwerveDrive::drivePose(SwervePose pose)
     // frc::SmartDashboard::PutNumber("XVel", xVel);
     // frc::SmartDashboard::PutNumber("YVel", yVel);
     // frc::SmartDashboard::PutNumber("YawVel", -yawVel);
-    calcModules(xVel, yVel, /*pose.getXAcc(), pose.getYAcc(),*/ -yawVel, /*-pose.getYawAcc(),*/ true);
-    // calcModules(xVel, yVel, 0, 0, -yawVel, 0, true);
+    calcModules(xVel, yVel, pose.getXAcc() * scale * scale, pose.getYAcc() * scale * scale, -yawVel, -pose.getYawAcc() * scale * scale, true, TRANSLATION);
 
-    topRight_->periodic(trSpeed_, trAngle_, true);
-    topLeft_->periodic(tlSpeed_, tlAngle_, true);
-    bottomRight_->periodic(brSpeed_, brAngle_, true);
-    bottomLeft_->periodic(blSpeed_, blAngle_, true);
+    // Slow the path down to what the wheels could do of it, both axes so they stay on the same path time, turning cut
+    // back to keep the translation included. Speeds back up once there's room.
+    pathTimeScale_ = std::clamp(scale * std::min(translationScale_, turnScale_) + SwerveConstants::PATH_TIME_RECOVERY * LoopConstants::SEQUENCING_PERIOD,
+                                SwerveConstants::MIN_PATH_TIME_SCALE, 1.0);
+
+    topRight_->periodic(trSpeed_, trAngle_, trAcc_, trAngVel_);
+    topLeft_->periodic(tlSpeed_, tlAngle_, tlAcc_, tlAngVel_);
+    bottomRight_->periodic(brSpeed_, brAngle_, brAcc_, brAngVel_);
+    bottomLeft_->periodic(blSpeed_, blAngle_, blAcc_, blAngVel_);
 }
 
 void SwerveDrive::adjustPos(SwervePose pose)
@@ -783,170 +901,212 @@ void SwerveDrive::adjustPos(SwervePose pose)
         yawVel = (pose.getYaw() - (yaw_)) * SwerveConstants::kaP * 8;
     }
 
-    // calcModules(xVel, yVel, pose.getXAcc(), pose.getYAcc(), -yawVel, -pose.getYawAcc(), true);
-    calcModules(xVel, yVel, /*0, 0,*/ -yawVel, /*0,*/ true);
+    calcModules(xVel, yVel, 0, 0, -yawVel, 0, true);
 
-    topRight_->periodic(trSpeed_, trAngle_, true);
-    topLeft_->periodic(tlSpeed_, tlAngle_, true);
-    bottomRight_->periodic(brSpeed_, brAngle_, true);
-    bottomLeft_->periodic(blSpeed_, blAngle_, true);
+    topRight_->periodic(trSpeed_, trAngle_, trAcc_, trAngVel_);
+    topLeft_->periodic(tlSpeed_, tlAngle_, tlAcc_, tlAngVel_);
+    bottomRight_->periodic(brSpeed_, brAngle_, brAcc_, brAngVel_);
+    bottomLeft_->periodic(blSpeed_, blAngle_, blAcc_, blAngVel_);
 }
 
 /*
- * Calculates the module's orientation and power output
+ * Calculates the module's orientation and power output, and from the accelerations each wheel's acceleration and how
+ * fast each module has to turn to keep up
+ *
+ * @param inMeters Speeds are in m/s and deg/s (and accelerations in m/s^2 and deg/s^2), otherwise fractions of max speed
+ * @param priority What to keep when the wheels can't do both the translation and the rotation
  */
-void SwerveDrive::calcModules(double xSpeed, double ySpeed, /*double xAcc, double yAcc,*/ double turn, /*double turnAcc,*/ bool inVolts)
+void SwerveDrive::calcModules(double xSpeed, double ySpeed, double xAcc, double yAcc, double turn, double turnAcc, bool inMeters, DrivePriority priority)
 {
     // https://www.first1684.com/uploads/2/0/1/6/20161347/chimiswerve_whitepaper__2_.pdf
     // https://www.desmos.com/calculator/bxk1qdap5l incomplete desmos
     // Robot's angle in radians
     double angle = yaw_ * (M_PI / 180);
 
+    double radius = SwerveConstants::WHEEL_DIAGONAL / 2;
+    if (inMeters)
+    {
+        // Convert to radians, then multiply by the radius to get tangential speed & accelerations
+        turn = (turn * M_PI / 180) * radius;
+        turnAcc = (turnAcc * M_PI / 180) * radius;
+    }
+    else
+    {
+        xSpeed *= SwerveConstants::MAX_TELE_VEL;
+        ySpeed *= SwerveConstants::MAX_TELE_VEL;
+        turn *= SwerveConstants::MAX_TELE_VEL;
+        xAcc *= SwerveConstants::MAX_TELE_VEL;
+        yAcc *= SwerveConstants::MAX_TELE_VEL;
+        turnAcc *= SwerveConstants::MAX_TELE_VEL;
+    }
+
     // Rotate the velocities by the robot's rotation (Robot-Orient the velocity) i.e. decompose vectors
     double newX = xSpeed * cos(angle) + ySpeed * sin(angle);
     double newY = ySpeed * cos(angle) + xSpeed * -sin(angle);
 
-    // Rotate acceleration (Robot-Orient)
-    // double newXAcc = xAcc * cos(angle) + yAcc * sin(angle);
-    // double newYAcc = yAcc * cos(angle) + xAcc * -sin(angle);
+    // Scale the velocity and acceleration
+    double turnComponent = turn / sqrt(2);
+    double turnAccComponent = turnAcc / sqrt(2);
+
+    // Scale the whole command down until every wheel can do it, clamping modules one by one changes the direction
+    desaturate(newX, newY, turnComponent, priority, translationScale_, turnScale_);
+    newX *= translationScale_;
+    newY *= translationScale_;
+    xAcc *= translationScale_;
+    yAcc *= translationScale_;
+    turn *= turnScale_;
+    turnComponent *= turnScale_;
+    turnAccComponent *= turnScale_;
+
+    // What the robot will actually do
+    achievedXVel_ = xSpeed * translationScale_;
+    achievedYVel_ = ySpeed * translationScale_;
+    achievedYawVel_ = -(turn / radius) * 180 / M_PI;
+
+    // Rotate acceleration (Robot-Orient). The robot frame turns with the robot (yaw goes the other way from turn), so a
+    // constant field velocity still changes in it.
+    double omega = turn / radius;
+    double newXAcc = xAcc * cos(angle) + yAcc * sin(angle) - omega * newY;
+    double newYAcc = yAcc * cos(angle) + xAcc * -sin(angle) + omega * newX;
 
-    // Calculate the turning if the turn and turnaccel is in degrees
-    if (inVolts)
+    // https://www.first1684.com/uploads/2/0/1/6/20161347/chimiswerve_whitepaper__2_.pdf
+    // Module positions are (1, 1) top right, (-1, 1) top left, (1, -1) bottom right, (-1, -1) bottom left. In the robot
+    // frame they don't move, so there's no centripetal term, the frame turning is already in newXAcc and newYAcc.
+    bool moving = (xSpeed != 0 || ySpeed != 0 || turn != 0);
+    calcModule(newX, newY, newXAcc, newYAcc, turnComponent, turnAccComponent, 1, 1, moving, trSpeed_, trAngle_, trAcc_, trAngVel_);
+    calcModule(newX, newY, newXAcc, newYAcc, turnComponent, turnAccComponent, -1, 1, moving, tlSpeed_, tlAngle_, tlAcc_, tlAngVel_);
+    calcModule(newX, newY, newXAcc, newYAcc, turnComponent, turnAccComponent, 1, -1, moving, brSpeed_, brAngle_, brAcc_, brAngVel_);
+    calcModule(newX, newY, newXAcc, newYAcc, turnComponent, turnAccComponent, -1, -1, moving, blSpeed_, blAngle_, blAcc_, blAngVel_);
+}
+
+/**
+ * Fastest any module has to go for a robot oriented velocity and per axis turn component
+ */
+double SwerveDrive::maxModuleSpeed(double x, double y, double turn)
+{
+    double max = 0;
+    for (int posX : {1, -1})
     {
-        // Convert to radians, then multiply by the radius to get tangential speed & accelerations
-        turn = (turn * M_PI / 180) * (SwerveConstants::WHEEL_DIAGONAL / 2);
-        // turnAcc = (turnAcc * M_PI / 180) * (SwerveConstants::WHEEL_DIAGONAL / 2);
+        for (int posY : {1, -1})
+        {
+            max = std::max(max, hypot(x + turn * posY, y - turn * posX));
+        }
     }
+    return max;
+}
 
-    // Scale the velocity and acceleration
-    double turnComponent = sqrt(turn * turn / 2);
-    // double turnAccComponent = sqrt(turnAcc * turnAcc / 2);
-    if (turn < 0)
+/**
+ * Finds how much to scale the translation and rotation so no module goes over the max speed
+ *
+ * @param x, y, turn Robot oriented velocity and per axis turn component
+ * @param priority UNIFORM scales both the same, TRANSLATION only slows the rotation (and the translation too if it's
+ * too fast on its own), ROTATION the other way around
+ * @param translationScale, turnScale Outputs, from 0 to 1
+ */
+void SwerveDrive::desaturate(double x, double y, double turn, DrivePriority priority, double &translationScale, double &turnScale)
+{
+    double maxSpeed = SwerveConstants::MAX_TELE_VEL;
+    translationScale = 1;
+    turnScale = 1;
+
+    double max = maxModuleSpeed(x, y, turn);
+    if (max <= maxSpeed)
     {
-        turnComponent *= -1;
+        return;
     }
-    // if (turnAcc < 0)
-    // {
-    //     turnAccComponent *= -1;
-    // }
 
-    // https://www.first1684.com/uploads/2/0/1/6/20161347/chimiswerve_whitepaper__2_.pdf
-    double A = newX - (turnComponent);
-    double B = newX + (turnComponent);
-    double C = newY - (turnComponent);
-    double D = newY + (turnComponent);
-
-    double trVel = sqrt(B * B + C * C);
-    double tlVel = sqrt(B * B + D * D);
-    double brVel = sqrt(A * A + C * C);
-    double blVel = sqrt(A * A + D * D);
-
-    // double AA = newXAcc - (turnAccComponent);
-    // double BA = newXAcc + (turnAccComponent);
-    // double CA = newYAcc - (turnAccComponent);
-    // double DA = newYAcc + (turnAccComponent);
-
-    // double trAcc = sqrt(BA * BA + CA * CA);
-    // double tlAcc = sqrt(BA * BA + DA * DA);
-    // double brAcc = sqrt(AA * AA + CA * CA);
-    // double blAcc = sqrt(AA * AA + DA * DA);
-
-    if (xSpeed != 0 || ySpeed != 0 || turn != 0)
+    if (priority == UNIFORM)
     {
-        trAngle_ = -atan2(B, C) * 180 / M_PI;
-        tlAngle_ = -atan2(B, D) * 180 / M_PI;
-        brAngle_ = -atan2(A, C) * 180 / M_PI;
-        blAngle_ = -atan2(A, D) * 180 / M_PI;
+        translationScale = maxSpeed / max;
+        turnScale = maxSpeed / max;
+        return;
     }
-    // else
-    // {
-    //     trAngle_ = 90;
-    //     tlAngle_ = 90;
-    //     brAngle_ = 90;
-    //     blAngle_ = 90;
-    // }
 
-    double maxSpeed;
-    if (inVolts)
+    // The kept one is too fast on its own, the other one gets nothing
+    double translation = hypot(x, y);
+    double rotation = abs(turn) * sqrt(2);
+    if (priority == TRANSLATION && translation >= maxSpeed)
     {
-        if (trVel != 0)
-        {
-            trSpeed_ = /*(trAcc / SwerveConstants::klA) + */ (trVel - SwerveConstants::klVI) / SwerveConstants::klV;
-        }
-        else
-        {
-            trSpeed_ = 0;
-        }
-
-        if (tlVel != 0)
-        {
-            tlSpeed_ = /*(tlAcc / SwerveConstants::klA) + */ (tlVel - SwerveConstants::klVI) / SwerveConstants::klV;
-        }
-        else
-        {
-            tlSpeed_ = 0;
-        }
-
-        if (brVel != 0)
-        {
-            brSpeed_ = /*(brAcc / SwerveConstants::klA) + */ (brVel - SwerveConstants::klVI) / SwerveConstants::klV;
-        }
-        else
-        {
-            brSpeed_ = 0;
-        }
+        translationScale = maxSpeed / translation;
+        turnScale = 0;
+        return;
+    }
+    if (priority == ROTATION && rotation >= maxSpeed)
+    {
+        translationScale = 0;
+        turnScale = maxSpeed / rotation;
+        return;
+    }
 
-        if (blVel != 0)
+    // The max module speed only goes up with the scale, so bisect for where it hits the max
+    double low = 0, high = 1;
+    for (int i = 0; i < 20; i++)
+    {
+        double mid = (low + high) / 2;
+        double speed = (priority == TRANSLATION) ? maxModuleSpeed(x, y, turn * mid) : maxModuleSpeed(x * mid, y * mid, turn);
+        if (speed > maxSpeed)
         {
-            blSpeed_ = /*(blAcc / SwerveConstants::klA) + */ (blVel - SwerveConstants::klVI) / SwerveConstants::klV;
+            high = mid;
         }
         else
         {
-            blSpeed_ = 0;
+            low = mid;
         }
+    }
 
-        maxSpeed = GeneralConstants::MAX_VOLTAGE;
+    if (priority == TRANSLATION)
+    {
+        turnScale = low;
     }
     else
     {
-        trSpeed_ = trVel;
-        tlSpeed_ = tlVel;
-        brSpeed_ = brVel;
-        blSpeed_ = blVel;
-        maxSpeed = 1;
+        translationScale = low;
     }
+}
 
-    if (trSpeed_ > maxSpeed || tlSpeed_ > maxSpeed || brSpeed_ > maxSpeed || brSpeed_ > maxSpeed)
-    {
-        double max = trSpeed_;
-
-        max = (tlSpeed_ > max) ? tlSpeed_ : max;
-        max = (brSpeed_ > max) ? brSpeed_ : max;
-        max = (blSpeed_ > max) ? blSpeed_ : max;
+/**
+ * Second order kinematics for one module, robot oriented
+ *
+ * @param x, y Robot velocity
+ * @param xAcc, yAcc Robot acceleration
+ * @param turn, turnAcc Per axis components of the rotation's tangential speed and acceleration
+ * @param posX, posY Which corner the module is on, 1 or -1
+ * @param moving If the angle should be updated, otherwise the module keeps its last angle
+ * @param speed, angle, acc, angVel Outputs, m/s, degrees, m/s^2 along the wheel, and deg/s of the module
+ */
+void SwerveDrive::calcModule(double x, double y, double xAcc, double yAcc, double turn, double turnAcc, int posX, int posY, bool moving,
+                             double &speed, double &angle, double &acc, double &angVel)
+{
+    double vx = x + turn * posY;
+    double vy = y - turn * posX;
+    double ax = xAcc + turnAcc * posY;
+    double ay = yAcc - turnAcc * posX;
 
-        trSpeed_ = (trSpeed_ / max);
-        tlSpeed_ = (tlSpeed_ / max);
-        brSpeed_ = (brSpeed_ / max);
-        blSpeed_ = (blSpeed_ / max);
+    speed = sqrt(vx * vx + vy * vy);
+    if (moving)
+    {
+        angle = -atan2(vx, vy) * 180 / M_PI;
+    }
 
-        if (inVolts)
-        {
-            trSpeed_ *= GeneralConstants::MAX_VOLTAGE;
-            tlSpeed_ *= GeneralConstants::MAX_VOLTAGE;
-            brSpeed_ *= GeneralConstants::MAX_VOLTAGE;
-            blSpeed_ *= GeneralConstants::MAX_VOLTAGE;
-        }
+    if (speed == 0)
+    {
+        acc = 0;
+        angVel = 0;
+        return;
     }
+
+    // d/dt |v| and d/dt -atan2(vx, vy)
+    acc = (vx * ax + vy * ay) / speed;
+    angVel = -((vy * ax - vx * ay) / (speed * speed)) * 180 / M_PI;
 }
 
 /**
  * Updates odometry based off wheel readings
  */
-void SwerveDrive::calcOdometry()
+void SwerveDrive::calcOdometry(double time)
 {
-    // Find difference in time between frames
-    double time = timer_.GetFPGATimestamp().value();
-    dT_ = time - prevTime_;
+    // Find difference in time between frames, the first one is a control period
+    dT_ = prevTime_ < 0 ? LoopConstants::CONTROL_PERIOD : time - prevTime_;
     prevTime_ = time;
 
     // if (!frc::DriverStation::IsEnabled()) // Do not calc odomotry if the robot is not moving; reset it
@@ -1014,6 +1174,31 @@ double SwerveDrive::getY()
     return robotY_;
 }
 
+/**
+ * The field oriented velocity (m/s) the last command actually asked for, after desaturation
+ */
+pair<double, double> SwerveDrive::getAchievedXYVel()
+{
+    return {achievedXVel_, achievedYVel_};
+}
+
+/**
+ * The yaw velocity (deg/s) the last command actually asked for, after desaturation
+ */
+double SwerveDrive::getAchievedYawVel()
+{
+    return achievedYawVel_;
+}
+
+/**
+ * How fast a path follower should run its path time, 1 for real time. Below 1 while the last drivePose() was more than
+ * the wheels could do. The tag lineup can't slow its clock, it gets the slower feedforward and catches up on P.
+ */
+double SwerveDrive::getPathTimeScale()
+{
+    return pathTimeScale_;
+}
+
 /**
  * Returns pair of xy velocities
  */
@@ -1067,7 +1252,7 @@ void SwerveDrive::setPos(pair<double, double> xy)
 /**
  * Using april tags to update field odometry
  */
-void SwerveDrive::updateAprilTagFieldXY(double tilt, vector<double> data)
+void SwerveDrive::updateAprilTagFieldXY(double tilt, vector<double> data, double time)
 {
     //-1 is no april tag
     // double defaultVal[] = {-1};
@@ -1117,7 +1302,7 @@ void SwerveDrive::updateAprilTagFieldXY(double tilt, vector<double> data)
 
     if (uniqueVal == prevUniqueVal_)
     {
-        frc::SmartDashboard::PutBoolean("Different Tag", false);
+        differentTag_ = false;
         if (robotX_ > 3.919857 + 2 && robotX_ < 12.621893 - 2) // If robot is not near community nor loading station
         {
             // foundTag_ = false;
@@ -1126,7 +1311,7 @@ void SwerveDrive::updateAprilTagFieldXY(double tilt, vector<double> data)
     }
     else
     {
-        frc::SmartDashboard::PutBoolean("Different Tag", true);
+        differentTag_ = true;
         prevUniqueVal_ = uniqueVal;
     }
     if (tagID < 1 || tagID > 8) // Ignore for now
@@ -1183,8 +1368,8 @@ void SwerveDrive::updateAprilTagFieldXY(double tilt, vector<double> data)
         aprilTagY = fieldTagY - orientedTagX;
     }
 
-    frc::SmartDashboard::PutNumber("AT X", aprilTagX);
-    frc::SmartDashboard::PutNumber("AT Y", aprilTagY);
+    tagFieldX_ = aprilTagX;
+    tagFieldY_ = aprilTagY;
 
     if (aprilTagX < 0 || aprilTagY < 0 || aprilTagX > FieldConstants::FIELD_LENGTH || aprilTagY > FieldConstants::FIELD_WIDTH) // If rbot is out of bounds
     {
@@ -1229,9 +1414,18 @@ void SwerveDrive::updateAprilTagFieldXY(double tilt, vector<double> data)
         // robotX_ += (-robotX_ + aprilTagX) * (0.1 / (1 + 1 * vel));
         // robotY_ += (-robotY_ + aprilTagY) * (0.1 / (1 + 1 * vel));
 
-        double time = timer_.GetFPGATimestamp().value();
-        auto historicalPose = prevPoses_.lower_bound(time - SwerveConstants::CAMERA_DELAY - delay);
-        if (historicalPose != prevPoses_.end() && abs(historicalPose->first - (time - SwerveConstants::CAMERA_DELAY) < 0.007))
+        // Use the capture time from the synced jetson clock when there is one, otherwise guess it from the fixed delay + age
+        double captureTime;
+        if (data.size() > 7 && data.at(7) > 0)
+        {
+            captureTime = data.at(7);
+        }
+        else
+        {
+            captureTime = time - SwerveConstants::CAMERA_DELAY - delay;
+        }
+        auto historicalPose = prevPoses_.lower_bound(captureTime);
+        if (historicalPose != prevPoses_.end() && abs(historicalPose->first - captureTime) < 0.007)
         {
             // frc::SmartDashboard::PutNumber("HX", historicalPose->second.first.first);
             // frc::SmartDashboard::PutNumber("HY", historicalPose->second.first.second);
@@ -1,6 +1,10 @@
 #include "Drivebase/SwerveModule.h"
 
-SwerveModule::SwerveModule(int turnID, int driveID, int cancoderID, double offset) : turnMotor_(turnID, "drivebase"), driveMotor_(driveID, "drivebase"), cancoder_(cancoderID, "drivebase"), trajectoryCalc_(maxV, maxA, kP, kD, kV, kA, kVI), offset_(offset)
+/**
+ * @param kVScale Multiplies DRIVE_KV for this module, for wheels that run faster or slower than the fit
+ */
+SwerveModule::SwerveModule(int turnID, int driveID, int cancoderID, double offset, double kVScale) : turnMotor_(turnID, CANConstants::DRIVEBASE_BUS), driveMotor_(driveID, CANConstants::DRIVEBASE_BUS), cancoder_(cancoderID, CANConstants::DRIVEBASE_BUS),
+    driveHealth_("Drive " + std::to_string(driveID)), cancoderHealth_("CANCoder " + std::to_string(cancoderID)), trajectoryCalc_(maxV, maxA, kP, kD, kV, kA, kVI), offset_(offset), kVScale_(kVScale)
 {
     turnMotor_.SetInverted(TalonFXInvertType::CounterClockwise);
     driveMotor_.SetInverted(TalonFXInvertType::Clockwise);
@@ -8,26 +12,178 @@ SwerveModule::SwerveModule(int turnID, int driveID, int cancoderID, double offse
     turnMotor_.SetNeutralMode(NeutralMode::Brake);
     driveMotor_.SetNeutralMode(NeutralMode::Brake);
 
+    CANSignals::configureOutputMotor(turnMotor_);
+    CANSignals::configureFeedbackMotor(driveMotor_, CANConstants::DRIVE_FRAME_PERIOD);
+    CANSignals::configureCANCoder(cancoder_);
+    if (!SwerveConstants::ONBOARD_CLOSED_LOOP)
+    {
+        // the steering loop is on the rio, outputs have to go out every run
+        CANSignals::setControlPeriod(turnMotor_, CANConstants::FAST_FRAME_PERIOD);
+    }
+
     id_ = std::to_string(driveID);
 
     initTrajectory_ = false;
     cancoder_.ClearStickyFaults(); 
+    sample();
+    continuousAngle_ = sample_.angle;
+    steerAngle_ = continuousAngle_;
+    prevTime_ = -1;
+
+    if (SwerveConstants::ONBOARD_CLOSED_LOOP)
+    {
+        configureOnboard();
+    }
+}
+
+/**
+ * Sets up the talon loops and seeds the turn motor's encoder from the cancoder, so motor position is module angle
+ */
+void SwerveModule::configureOnboard()
+{
+    double ticksPerDegree = GeneralConstants::TICKS_PER_ROTATION / 360.0 / SwerveConstants::SWIVEL_GEAR_RATIO;
+
+    turnMotor_.ConfigSelectedFeedbackSensor(FeedbackDevice::IntegratedSensor);
+    turnMotor_.Config_kP(0, SwerveConstants::STEER_KP);
+    turnMotor_.Config_kD(0, SwerveConstants::STEER_KD);
+    turnMotor_.ConfigVoltageCompSaturation(GeneralConstants::MAX_VOLTAGE);
+    turnMotor_.EnableVoltageCompensation(true);
+    turnMotor_.ConfigMotionCruiseVelocity(SwerveConstants::STEER_CRUISE_VEL * ticksPerDegree / 10);
+    turnMotor_.ConfigMotionAcceleration(SwerveConstants::STEER_ACCEL * ticksPerDegree / 10);
+    turnMotor_.SetSelectedSensorPosition(continuousAngle_ * ticksPerDegree);
+
+    // arbitrary feedforward is a percent, this makes it volts
+    driveMotor_.ConfigVoltageCompSaturation(GeneralConstants::MAX_VOLTAGE);
+    driveMotor_.EnableVoltageCompensation(true);
+    driveMotor_.ConfigSelectedFeedbackSensor(FeedbackDevice::IntegratedSensor);
+    driveMotor_.Config_kP(0, SwerveConstants::DRIVE_KP);
+    driveMotor_.Config_kF(0, 0);
+}
+
+/**
+ * Reads the cancoder and drive encoder once, everything else this loop uses these values
+ */
+const SwerveModule::Sample &SwerveModule::sample()
+{
+    double angle = cancoder_.GetAbsolutePosition() + offset_;
+    cancoderHealth_.update(cancoder_.GetLastError(), cancoder_.GetLastTimestamp());
+    Helpers::normalizeAngle(angle);
+
+    double delta = angle - sample_.angle;
+    Helpers::normalizeAngle(delta);
+    continuousAngle_ += delta;
+    sample_.angle = angle;
+
+    //Heavy ratio to degrees
+    sample_.driveVelocity = (driveMotor_.GetSelectedSensorVelocity() / 2048) * 10 * SwerveConstants::DRIVE_GEAR_RATIO * 2 * M_PI * SwerveConstants::TREAD_RADIUS;
+    driveHealth_.update(driveMotor_.GetLastError());
+    return sample_;
+}
+
+void SwerveModule::registerTelemetry(Telemetry &telemetry)
+{
+    driveHealth_.registerTelemetry(telemetry);
+    cancoderHealth_.registerTelemetry(telemetry);
 }
 
-void SwerveModule::periodic(double driveSpeed, double angle, bool inVolts)
+void SwerveModule::logTelemetry(Telemetry &telemetry)
 {
-    double time = timer_.GetFPGATimestamp().value();
-    // frc::SmartDashboard::PutNumber(id_ + " time", time);
-    // frc::SmartDashboard::PutNumber(id_ + " sp", driveSpeed);
+    driveHealth_.logTelemetry(telemetry);
+    cancoderHealth_.logTelemetry(telemetry);
+}
+
+/**
+ * Sets what the module should do, it gets applied by update() in the fast control task
+ *
+ * @param velocity Wheel speed in m/s
+ * @param angle Robot oriented, in degrees
+ * @param acceleration Wheel acceleration in m/s^2, for the feedforward
+ * @param angularVelocity How fast the angle is changing in deg/s, fed forward to the steering and used to keep the
+ * angle moving between setpoints
+ */
+void SwerveModule::periodic(double velocity, double angle, double acceleration, double angularVelocity)
+{
+    // frc::SmartDashboard::PutNumber(id_ + " sp", velocity);
     // frc::SmartDashboard::PutNumber(id_ + " ang", angle);
-    dT_ = time - prevTime_;
+    setVelocity_ = velocity;
+    setAngle_ = angle;
+    setAcceleration_ = acceleration;
+    setAngularVelocity_ = angularVelocity;
+    extrapolatedTime_ = 0;
+}
+
+/**
+ * Runs the steering loop and drive output for the last setpoint, every fast control task run
+ *
+ * @param time The loop's timestamp in seconds, from the robot snapshot
+ */
+void SwerveModule::update(double time)
+{
+    // the first run is a control period, so the steering D term doesn't divide by zero
+    dT_ = prevTime_ < 0 ? LoopConstants::CONTROL_PERIOD : time - prevTime_;
     prevTime_ = time;
-    
-    move(driveSpeed, angle, inVolts);
+
+    // setpoints only come in every sequencing run, follow one for at most that long in case the next never comes
+    double extrapolate = std::min(dT_, LoopConstants::SEQUENCING_PERIOD - extrapolatedTime_);
+    if (extrapolate > 0)
+    {
+        setAngle_ += setAngularVelocity_ * extrapolate;
+        extrapolatedTime_ += extrapolate;
+    }
+
+    if (SwerveConstants::ONBOARD_CLOSED_LOOP)
+    {
+        moveOnboard(setVelocity_, setAngle_, setAcceleration_);
+    }
+    else
+    {
+        move(setVelocity_, setAngle_, setAcceleration_);
+    }
+}
+
+/**
+ * Moves the steering target toward the wanted angle, by whichever way is shorter with the wheel either way around, at
+ * most MAX_STEER_RATE. The target is a continuous angle so it never wraps, and the module never turns more than 90.
+ *
+ * @param angle Wanted angle, robot oriented, in degrees
+ * @returns How much of the wanted velocity the wheel can give where it's pointed now, the cosine of the error between
+ * the actual angle and the wanted angle. Negative when the wheel is backwards.
+ */
+double SwerveModule::optimize(double angle)
+{
+    double delta = findError(angle, steerAngle_);
+    double maxDelta = SwerveConstants::MAX_STEER_RATE * dT_;
+    steerAngle_ += std::clamp(delta, -maxDelta, maxDelta);
+
+    return cos((angle - getAngle()) * M_PI / 180);
+}
+
+/**
+ * Same as move(), but with the loops running on the talons. The talon closes the velocity loop and the feedforward goes
+ * along as arbitrary feedforward.
+ */
+void SwerveModule::moveOnboard(double velocity, double angle, double acceleration)
+{
+    double scale = optimize(angle);
+    velocity *= scale;
+    acceleration *= scale;
+
+    double ticksPerDegree = GeneralConstants::TICKS_PER_ROTATION / 360.0 / SwerveConstants::SWIVEL_GEAR_RATIO;
+    turnMotor_.Set(ControlMode::MotionMagic, steerAngle_ * ticksPerDegree, DemandType::DemandType_ArbitraryFeedForward, calcSteerFeedForward() / GeneralConstants::MAX_VOLTAGE);
+
+    double volts = std::clamp(calcDriveFeedForward(velocity, acceleration), -(double)GeneralConstants::MAX_VOLTAGE, (double)GeneralConstants::MAX_VOLTAGE);
+
+    // m/s to ticks/100ms
+    double ticksPerMeter = GeneralConstants::TICKS_PER_ROTATION / (2 * M_PI * SwerveConstants::TREAD_RADIUS * SwerveConstants::DRIVE_GEAR_RATIO);
+    driveMotor_.Set(ControlMode::Velocity, velocity * ticksPerMeter / 10, DemandType::DemandType_ArbitraryFeedForward, volts / GeneralConstants::MAX_VOLTAGE);
 }
 
-void SwerveModule::move(double driveSpeed, double angle, bool inVolts)
+void SwerveModule::move(double velocity, double angle, double acceleration)
 {
+    double scale = optimize(angle);
+    velocity *= scale;
+    acceleration *= scale;
+
     //frc::SmartDashboard::PutNumber(id_ + " Wanted speed", driveSpeed);
     //frc::SmartDashboard::PutNumber(id_ + " Wanted angle", angle);
 
@@ -118,7 +274,7 @@ void SwerveModule::move(double driveSpeed, double angle, bool inVolts)
     //6, 
     //6.5, 
 
-    units::volt_t turnVolts{calcAngPID(angle)};
+    units::volt_t turnVolts{std::clamp(calcAngPID(steerAngle_) + calcSteerFeedForward(), -(double)GeneralConstants::MAX_VOLTAGE, (double)GeneralConstants::MAX_VOLTAGE)};
     turnMotor_.SetVoltage(turnVolts);
 
     // if(abs(driveSpeed) < 0.1)
@@ -131,15 +287,8 @@ void SwerveModule::move(double driveSpeed, double angle, bool inVolts)
     // }
     // frc::SmartDashboard::PutNumber(id_ + " vel", (driveMotor_.GetSelectedSensorVelocity() / 2048.0) * 10 * SwerveConstants::DRIVE_GEAR_RATIO * 2 * M_PI * SwerveConstants::TREAD_RADIUS);
     
-    if(inVolts)
-    {
-        driveMotor_.SetVoltage(units::volt_t(direction_ * driveSpeed));
-    }
-    else
-    {
-        units::volt_t driveVolts{direction_ * calcDrivePID(driveSpeed)};
-        driveMotor_.SetVoltage(driveVolts);
-    }
+    units::volt_t driveVolts{calcDrivePID(velocity, acceleration)};
+    driveMotor_.SetVoltage(driveVolts);
 
     //Turn with arm
     //0.74, 0
@@ -164,10 +313,13 @@ void SwerveModule::move(double driveSpeed, double angle, bool inVolts)
 //11, 2730
 //12, 2855
 
+/**
+ * @param setAngle Continuous angle to steer to, in degrees
+ */
 double SwerveModule::calcAngPID(double setAngle)
 {
 
-    double error = findError(setAngle, getAngle());
+    double error = setAngle - continuousAngle_;
     //frc::SmartDashboard::PutNumber(id_ + "Error", error);
 
     aIntegralError_ += error * dT_;
@@ -185,55 +337,60 @@ double SwerveModule::calcAngPID(double setAngle)
     return std::clamp(power, -(double)GeneralConstants::MAX_VOLTAGE, (double)GeneralConstants::MAX_VOLTAGE);
 }
 
-double SwerveModule::calcDrivePID(double driveSpeed)
+/**
+ * Volts to turn the module at the commanded angular velocity, from the steering characterization (kV and kVI)
+ */
+double SwerveModule::calcSteerFeedForward()
 {
-    // double velocity = (driveSpeed * GeneralConstants::MAX_RPM * GeneralConstants::TICKS_PER_ROTATION) / 600;
-    // double error = velocity - driveMotor_.GetSelectedSensorVelocity(); //This is probably wrong
-
-    // dIntegralError_ += error * dT_;
-    // double deltaError = (error - dPrevError_) / dT_;
-    // dPrevError_ = error;
+    if (setAngularVelocity_ == 0)
+    {
+        return 0;
+    }
 
-    // if(abs(deltaError) < 40 && error > 100) //COULDO get value, also test if needed
-    // {
-    //     deltaError = 0;
-    //     dIntegralError_ = 0;
-    // }
+    double feedForward = (abs(setAngularVelocity_) - kVI) * kV;
+    return (setAngularVelocity_ > 0) ? feedForward : -feedForward;
+}
 
-    double feedForward = GeneralConstants::MAX_VOLTAGE * driveSpeed;
-    // double feedForward;
-    // if(driveSpeed == 0)
-    // {
-    //     feedForward = 0;
-    // }
-    // else
-    // {
-    //     feedForward = ((driveSpeed * SwerveConstants::MAX_TELE_VEL) - SwerveConstants::klVI) / SwerveConstants::klV;
-    // }
-    
+/**
+ * Volts to hold a wheel speed, kS + kV * v + kA * a. The constants are fit from the characterization data in move().
+ *
+ * @param velocity Wheel speed in m/s, in the direction the drive motor turns forward
+ * @param acceleration In m/s^2
+ */
+double SwerveModule::calcDriveFeedForward(double velocity, double acceleration)
+{
+    double feedForward = (SwerveConstants::DRIVE_KV * kVScale_ * velocity) + (SwerveConstants::DRIVE_KA * acceleration);
+    if (velocity > 0)
+    {
+        feedForward += SwerveConstants::DRIVE_KS;
+    }
+    else if (velocity < 0)
+    {
+        feedForward -= SwerveConstants::DRIVE_KS;
+    }
+    return feedForward;
+}
 
-    //double power = (dkP_*error) + (dkI_*aIntegralError_) + (dkD_*deltaError) + feedForward;
-    double power = feedForward;
+/**
+ * Feedforward plus a proportional velocity term
+ */
+double SwerveModule::calcDrivePID(double velocity, double acceleration)
+{
+    double error = velocity - sample_.driveVelocity;
+    double power = calcDriveFeedForward(velocity, acceleration) + (SwerveConstants::DRIVE_VEL_KP * error);
 
     return std::clamp(power, -(double)GeneralConstants::MAX_VOLTAGE, (double)GeneralConstants::MAX_VOLTAGE);
-
 }
 
+/**
+ * Error to whichever way around of setAngle is closer, the wheel can point either way
+ */
 double SwerveModule::findError(double setAngle, double angle)
 {
     double rawError = setAngle - angle;
 
     Helpers::normalizeAngle(rawError);
 
-    if(abs(rawError) > 90)
-    {
-        direction_ = -1;
-    }
-    else
-    {
-        direction_ = 1;
-    }
-    
     return (abs(rawError) <= 90) ? rawError : (rawError > 0) ? rawError - 180 : rawError + 180;
 }
 
@@ -243,8 +400,7 @@ double SwerveModule::findError(double setAngle, double angle)
 double SwerveModule::getDriveVelocity()
 {
     // frc::SmartDashboard::PutNumber(id_ + " vel", (driveMotor_.GetSelectedSensorVelocity() / 2048.0) * 10 * SwerveConstants::DRIVE_GEAR_RATIO * 2 * M_PI * SwerveConstants::TREAD_RADIUS);
-    //Heavy ratio to degrees
-    return (driveMotor_.GetSelectedSensorVelocity() / 2048) * 10 * SwerveConstants::DRIVE_GEAR_RATIO * 2 * M_PI * SwerveConstants::TREAD_RADIUS;
+    return sample_.driveVelocity;
 
 }
 
@@ -253,10 +409,7 @@ double SwerveModule::getDriveVelocity()
 */
 double SwerveModule::getAngle()
 {
-    double angle = cancoder_.GetAbsolutePosition() + offset_;
-    Helpers::normalizeAngle(angle);
-
     // frc::SmartDashboard::PutNumber(id_ + " apos", cancoder_.GetAbsolutePosition());
     // frc::SmartDashboard::PutNumber(id_ + " pos", angle);
-    return angle;
+    return sample_.angle;
 }
\ No newline at end of file
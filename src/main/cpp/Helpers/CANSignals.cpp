@@ -0,0 +1,249 @@
+#include "Helpers/CANSignals.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <ctre/phoenixpro/CANBus.hpp>
+#include <frc/RobotController.h>
+
+#include "Helpers/RealTime.h"
+
+/**
+ * A motor whose encoder gets read
+ *
+ * @param feedbackPeriod How often the encoder gets read, in ms
+ */
+void CANSignals::configureFeedbackMotor(WPI_TalonFX &motor, int feedbackPeriod)
+{
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_1_General, CANConstants::GENERAL_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_2_Feedback0, feedbackPeriod);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_Brushless_Current, CANConstants::CURRENT_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_4_AinTempVbat, CANConstants::SLOW_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_10_Targets, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_12_Feedback1, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_13_Base_PIDF0, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_14_Turn_PIDF1, CANConstants::UNUSED_FRAME_PERIOD);
+}
+
+/**
+ * A motor that only gets set, feedback comes from somewhere else (like the turn motors and their cancoders)
+ */
+void CANSignals::configureOutputMotor(WPI_TalonFX &motor)
+{
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_1_General, CANConstants::GENERAL_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_2_Feedback0, CANConstants::SLOW_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_Brushless_Current, CANConstants::SLOW_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_4_AinTempVbat, CANConstants::SLOW_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_10_Targets, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_12_Feedback1, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_13_Base_PIDF0, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_14_Turn_PIDF1, CANConstants::UNUSED_FRAME_PERIOD);
+}
+
+/**
+ * A follower, nothing reads it. General stays at its default so faults still show up.
+ */
+void CANSignals::configureFollowerMotor(WPI_TalonFX &motor)
+{
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_2_Feedback0, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_Brushless_Current, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_4_AinTempVbat, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_10_Targets, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_12_Feedback1, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_13_Base_PIDF0, CANConstants::UNUSED_FRAME_PERIOD);
+    motor.SetStatusFramePeriod(StatusFrameEnhanced::Status_14_Turn_PIDF1, CANConstants::UNUSED_FRAME_PERIOD);
+}
+
+void CANSignals::configureCANCoder(WPI_CANCoder &cancoder)
+{
+    cancoder.SetStatusFramePeriod(CANCoderStatusFrame_SensorData, CANConstants::FAST_FRAME_PERIOD);
+    cancoder.SetStatusFramePeriod(CANCoderStatusFrame_VbatAndFaults, CANConstants::SLOW_FRAME_PERIOD);
+}
+
+/**
+ * Sets how often the output gets sent, a new output only goes out with the next control frame
+ */
+void CANSignals::setControlPeriod(WPI_TalonFX &motor, int period)
+{
+    motor.SetControlFramePeriod(ControlFrame::Control_3_General, period);
+}
+
+CANDeviceHealth::CANDeviceHealth(std::string name)
+    : name_(name), errors_(0), repeats_(0), lastFrameTime_(-1), frameGap_(0), errorChannel_(0), repeatChannel_(0), gapChannel_(0)
+{
+}
+
+/**
+ * For devices that don't timestamp their frames (talons), only errors get counted
+ *
+ * @param error GetLastError() right after the read
+ */
+void CANDeviceHealth::update(ctre::phoenix::ErrorCode error)
+{
+    if (error != ctre::phoenix::ErrorCode::OK)
+    {
+        errors_++;
+    }
+}
+
+/**
+ * @param error GetLastError() right after the read
+ * @param frameTime GetLastTimestamp() right after the read, in seconds
+ */
+void CANDeviceHealth::update(ctre::phoenix::ErrorCode error, double frameTime)
+{
+    update(error);
+
+    if (lastFrameTime_ < 0)
+    {
+        lastFrameTime_ = frameTime;
+        return;
+    }
+
+    if (frameTime == lastFrameTime_)
+    {
+        repeats_++;
+    }
+    else
+    {
+        frameGap_ = std::max(frameGap_, frameTime - lastFrameTime_);
+        lastFrameTime_ = frameTime;
+    }
+}
+
+uint64_t CANDeviceHealth::getErrors()
+{
+    return errors_;
+}
+
+uint64_t CANDeviceHealth::getRepeats()
+{
+    return repeats_;
+}
+
+double CANDeviceHealth::getFrameGap()
+{
+    return frameGap_;
+}
+
+void CANDeviceHealth::registerTelemetry(Telemetry &telemetry)
+{
+    errorChannel_ = telemetry.addInteger("CAN/" + name_ + "/errors");
+    repeatChannel_ = telemetry.addInteger("CAN/" + name_ + "/repeats");
+    gapChannel_ = telemetry.addDouble("CAN/" + name_ + "/frame gap");
+}
+
+/**
+ * Logs the counters and the longest frame gap since the last call, then starts a new gap window
+ */
+void CANDeviceHealth::logTelemetry(Telemetry &telemetry)
+{
+    telemetry.log(errorChannel_, (int64_t)errors_);
+    telemetry.log(repeatChannel_, (int64_t)repeats_);
+    telemetry.log(gapChannel_, frameGap_);
+    frameGap_ = 0;
+}
+
+/**
+ * @param bus CANConstants::RIO_BUS or the name of a CANivore
+ */
+CANBusMonitor::CANBusMonitor(std::string bus)
+    : bus_(bus), utilization_(0), busOffCount_(0), txFullCount_(0), receiveErrors_(0), transmitErrors_(0), ok_(false), stopping_(false),
+      utilizationChannel_(0), busOffChannel_(0), txFullChannel_(0), receiveErrorChannel_(0), transmitErrorChannel_(0)
+{
+}
+
+CANBusMonitor::~CANBusMonitor()
+{
+    stop();
+}
+
+void CANBusMonitor::start()
+{
+    if (thread_.joinable())
+    {
+        return;
+    }
+
+    stopping_ = false;
+    thread_ = std::thread([this]
+                          { loop(); });
+}
+
+void CANBusMonitor::stop()
+{
+    if (!thread_.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopping_ = true;
+    }
+    stopCv_.notify_all();
+    thread_.join();
+}
+
+void CANBusMonitor::update()
+{
+    if (bus_ == CANConstants::RIO_BUS)
+    {
+        frc::CANStatus status = frc::RobotController::GetCANStatus();
+        utilization_.store(status.percentBusUtilization);
+        busOffCount_.store(status.busOffCount);
+        txFullCount_.store(status.txFullCount);
+        receiveErrors_.store(status.receiveErrorCount);
+        transmitErrors_.store(status.transmitErrorCount);
+        ok_.store(true);
+    }
+    else
+    {
+        ctre::phoenixpro::CANBus::CANBusStatus status = ctre::phoenixpro::CANBus::GetStatus(bus_);
+        if (status.Status.IsOK())
+        {
+            utilization_.store(status.BusUtilization);
+            busOffCount_.store(status.BusOffCount);
+            txFullCount_.store(status.TxFullCount);
+            receiveErrors_.store(status.REC);
+            transmitErrors_.store(status.TEC);
+        }
+        ok_.store(status.Status.IsOK());
+    }
+}
+
+void CANBusMonitor::loop()
+{
+    RealTime::makeCurrentThreadBackground(ThreadConstants::BACKGROUND_CORE);
+
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    while (!stopping_)
+    {
+        update();
+        stopCv_.wait_for(lock, std::chrono::duration<double>(CANConstants::BUS_STATUS_PERIOD), [this]
+                         { return stopping_; });
+    }
+}
+
+void CANBusMonitor::registerTelemetry(Telemetry &telemetry)
+{
+    utilizationChannel_ = telemetry.addDouble("CAN/" + bus_ + "/utilization");
+    busOffChannel_ = telemetry.addInteger("CAN/" + bus_ + "/bus off");
+    txFullChannel_ = telemetry.addInteger("CAN/" + bus_ + "/tx full");
+    receiveErrorChannel_ = telemetry.addInteger("CAN/" + bus_ + "/receive errors");
+    transmitErrorChannel_ = telemetry.addInteger("CAN/" + bus_ + "/transmit errors");
+}
+
+void CANBusMonitor::logTelemetry(Telemetry &telemetry)
+{
+    if (!ok_.load())
+    {
+        return;
+    }
+
+    telemetry.log(utilizationChannel_, utilization_.load());
+    telemetry.log(busOffChannel_, busOffCount_.load());
+    telemetry.log(txFullChannel_, txFullCount_.load());
+    telemetry.log(receiveErrorChannel_, receiveErrors_.load());
+    telemetry.log(transmitErrorChannel_, transmitErrors_.load());
+}
@@ -0,0 +1,8 @@
+#include "Helpers/FPGAClock.h"
+
+#include <frc/Timer.h>
+
+double FPGAClock::getTime()
+{
+    return frc::Timer::GetFPGATimestamp().value();
+}
@@ -0,0 +1,112 @@
+#include "Helpers/LoopTimer.h"
+
+#include <fmt/format.h>
+
+/**
+ * @param name Name for telemetry and the summary
+ * @param deadline Time in seconds that counts as an overrun
+ */
+LatencyHistogram::LatencyHistogram(std::string name, double deadline)
+    : name_(name), deadline_(deadline * 1000000), count_(0), overruns_(0), max_(0), p50Channel_(0), p99Channel_(0), maxChannel_(0), overrunChannel_(0)
+{
+    for (std::atomic<uint32_t> &bucket : buckets_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(int64_t us)
+{
+    int bucket = us / BUCKET_WIDTH;
+    if (bucket >= NUM_BUCKETS)
+    {
+        bucket = NUM_BUCKETS - 1;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    if (us > deadline_)
+    {
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int64_t prevMax = max_.load(std::memory_order_relaxed);
+    while (us > prevMax && !max_.compare_exchange_weak(prevMax, us, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<uint32_t> &bucket : buckets_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    overruns_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Gets a percentile, rounded up to the top of its bucket
+ *
+ * @param percentile From 0 to 1
+ * @returns The time in seconds
+ */
+double LatencyHistogram::getPercentile(double percentile)
+{
+    uint64_t count = count_.load(std::memory_order_relaxed);
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t target = percentile * count;
+    uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS - 1; i++)
+    {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen > target)
+        {
+            return (i + 1) * BUCKET_WIDTH / 1000000.0;
+        }
+    }
+    return getMax();
+}
+
+double LatencyHistogram::getMax()
+{
+    return max_.load(std::memory_order_relaxed) / 1000000.0;
+}
+
+uint64_t LatencyHistogram::getCount()
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getOverruns()
+{
+    return overruns_.load(std::memory_order_relaxed);
+}
+
+std::string LatencyHistogram::getSummary()
+{
+    return fmt::format("{}: n={} p50={:.3f}ms p99={:.3f}ms max={:.3f}ms overruns={}", name_, getCount(), getPercentile(0.5) * 1000,
+                       getPercentile(0.99) * 1000, getMax() * 1000, getOverruns());
+}
+
+void LatencyHistogram::registerTelemetry(Telemetry &telemetry)
+{
+    p50Channel_ = telemetry.addDouble("Timing/" + name_ + "/p50");
+    p99Channel_ = telemetry.addDouble("Timing/" + name_ + "/p99");
+    maxChannel_ = telemetry.addDouble("Timing/" + name_ + "/max");
+    overrunChannel_ = telemetry.addInteger("Timing/" + name_ + "/overruns");
+}
+
+void LatencyHistogram::logTelemetry(Telemetry &telemetry)
+{
+    telemetry.log(p50Channel_, getPercentile(0.5));
+    telemetry.log(p99Channel_, getPercentile(0.99));
+    telemetry.log(maxChannel_, getMax());
+    telemetry.log(overrunChannel_, (int64_t)getOverruns());
+}
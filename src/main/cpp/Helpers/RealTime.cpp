@@ -0,0 +1,36 @@
+#include "Helpers/RealTime.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <frc/Threads.h>
+
+/**
+ * @param priority SCHED_FIFO priority, 1 to 99
+ * @param core Core to pin to, -1 to leave it
+ * @returns If everything was set, fails without permission (like in sim)
+ */
+bool RealTime::makeCurrentThreadRealTime(int priority, int core)
+{
+    bool ok = frc::SetCurrentThreadPriority(true, priority);
+    return pinCurrentThread(core) && ok;
+}
+
+bool RealTime::makeCurrentThreadBackground(int core)
+{
+    bool ok = frc::SetCurrentThreadPriority(false, 0);
+    return pinCurrentThread(core) && ok;
+}
+
+bool RealTime::pinCurrentThread(int core)
+{
+    if (core < 0)
+    {
+        return true;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+}
@@ -0,0 +1,113 @@
+#include "Helpers/TaskScheduler.h"
+
+#include <fmt/format.h>
+#include <frc/RobotController.h>
+
+TaskScheduler::TaskScheduler(frc::TimedRobot &robot) : robot_(robot)
+{
+}
+
+/**
+ * Adds a task, call from the robot constructor
+ *
+ * @param name Name for telemetry and the summaries
+ * @param task What to run
+ * @param period Time between runs in seconds, also the deadline
+ * @param offset Time in seconds after the robot loop starts to run it, to keep tasks from lining up
+ */
+void TaskScheduler::addTask(std::string name, std::function<void()> task, double period, double offset)
+{
+    tasks_.push_back(std::unique_ptr<Task>(new Task{name, task, (int64_t)(period * 1000000), -1, 0, LatencyHistogram(name, period), 0}));
+    Task *t = tasks_.back().get();
+    robot_.AddPeriodic([this, t]
+                       { run(*t); },
+                       units::second_t{period}, units::second_t{offset});
+}
+
+void TaskScheduler::run(Task &task)
+{
+    int64_t start = frc::RobotController::GetFPGATime();
+    if (task.release < 0)
+    {
+        task.release = start;
+    }
+
+    // TimedRobot skips the periods it was too late for, every skipped one is a miss
+    int64_t late = start - task.release;
+    if (late >= task.period)
+    {
+        task.misses += late / task.period;
+        task.release += late / task.period * task.period;
+    }
+
+    task.task();
+
+    int64_t end = frc::RobotController::GetFPGATime();
+    task.times.record(end - start);
+    if (end > task.release + task.period)
+    {
+        task.misses++;
+    }
+    task.release += task.period;
+}
+
+void TaskScheduler::reset()
+{
+    for (std::unique_ptr<Task> &task : tasks_)
+    {
+        task->misses = 0;
+        task->times.reset();
+    }
+}
+
+TaskScheduler::Task *TaskScheduler::find(std::string name)
+{
+    for (std::unique_ptr<Task> &task : tasks_)
+    {
+        if (task->name == name)
+        {
+            return task.get();
+        }
+    }
+    return nullptr;
+}
+
+uint64_t TaskScheduler::getCount(std::string name)
+{
+    Task *task = find(name);
+    return task ? task->times.getCount() : 0;
+}
+
+uint64_t TaskScheduler::getMisses(std::string name)
+{
+    Task *task = find(name);
+    return task ? task->misses : 0;
+}
+
+std::vector<std::string> TaskScheduler::getSummaries()
+{
+    std::vector<std::string> summaries;
+    for (std::unique_ptr<Task> &task : tasks_)
+    {
+        summaries.push_back(fmt::format("{} misses={}", task->times.getSummary(), task->misses));
+    }
+    return summaries;
+}
+
+void TaskScheduler::registerTelemetry(Telemetry &telemetry)
+{
+    for (std::unique_ptr<Task> &task : tasks_)
+    {
+        task->times.registerTelemetry(telemetry);
+        task->missChannel = telemetry.addInteger("Timing/" + task->name + "/misses");
+    }
+}
+
+void TaskScheduler::logTelemetry(Telemetry &telemetry)
+{
+    for (std::unique_ptr<Task> &task : tasks_)
+    {
+        task->times.logTelemetry(telemetry);
+        telemetry.log(task->missChannel, (int64_t)task->misses);
+    }
+}
@@ -0,0 +1,9 @@
+#include "Helpers/Units.h"
+#include "GeneralConstants.h"
+
+namespace Helpers {
+units::radian_t convertStepsToRadians(double val, double numStepsPerRevolution) {
+  double valRad = val * (2 * M_PI / numStepsPerRevolution);
+  return units::radian_t{valRad};
+}
+} // namespace Helpers
@@ -6,48 +6,135 @@
 
 #include <fmt/core.h>
 
+#include <frc/DataLogManager.h>
+#include <frc/Notifier.h>
+#include <frc/RobotController.h>
 #include <frc/smartdashboard/SmartDashboard.h>
 
-Robot::Robot() : autoPaths_(swerveDrive_, arm_), socketClient_("10.1.14.43", 5807, 500, 5000)
+Robot::Robot() : autoPaths_(swerveDrive_, arm_),
+                 socketClient_(IsSimulation() ? GeneralConstants::SIM_JETSON_HOST : GeneralConstants::JETSON_HOST, GeneralConstants::JETSON_PORT, 500, 5000)
 {
+    Clock::setDefault(&tickClock_);
+
+    yawChannel_ = telemetry_.addDouble("yaw");
+    navxAliveChannel_ = telemetry_.addBoolean("navx alive");
+    dataStaleChannel_ = telemetry_.addBoolean("Data Stale");
+    cameraConnChannel_ = telemetry_.addBoolean("Camera Connection");
+    cameraStateChannel_ = telemetry_.addString("Camera State");
+    tiltChannel_ = telemetry_.addDouble("Tilt");
+    pitchChannel_ = telemetry_.addDouble("Pitch");
+    rollChannel_ = telemetry_.addDouble("Roll");
+
+    forwardChannel_ = telemetry_.addBoolean("Forward");
+    posKnownChannel_ = telemetry_.addBoolean("Pos Known");
+    intakingCubeChannel_ = telemetry_.addBoolean("Intaking Cube");
+    eStoppedChannel_ = telemetry_.addBoolean("ESTOPPED");
+    armsZeroedChannel_ = telemetry_.addBoolean("Arms Zeroed");
+    armStateChannel_ = telemetry_.addString("Arm State");
+    armPosChannel_ = telemetry_.addString("Arm Pos");
+    armSetPosChannel_ = telemetry_.addString("Arm Set Pos");
+    xChannel_ = telemetry_.addDouble("x");
+    yChannel_ = telemetry_.addDouble("y");
+    thetaChannel_ = telemetry_.addDouble("Theta");
+    phiChannel_ = telemetry_.addDouble("Phi");
+    scoringPosChannel_ = telemetry_.addInteger("Scoring Pos");
+    cutoutIntakingChannel_ = telemetry_.addBoolean("Cutout Intaking");
+    cutoutOutakingChannel_ = telemetry_.addBoolean("Cutout Outaking");
+    cubeIntakeDownChannel_ = telemetry_.addBoolean("Cube Intake Down");
+
+    swerveTimes_.registerTelemetry(telemetry_);
+    armTimes_.registerTelemetry(telemetry_);
+    visionTimes_.registerTelemetry(telemetry_);
+    intakeTimes_.registerTelemetry(telemetry_);
+    autoTimes_.registerTelemetry(telemetry_);
+    teleopDriveTimes_.registerTelemetry(telemetry_);
+    socketClient_.GetParseTimes().registerTelemetry(telemetry_);
+
+    swerveDrive_->registerTelemetry(telemetry_);
+    arm_->registerTelemetry(telemetry_);
+    autoPaths_.registerTelemetry(telemetry_);
+    rioBus_.registerTelemetry(telemetry_);
+    drivebaseBus_.registerTelemetry(telemetry_);
+
+    if (IsSimulation())
+    {
+        // The drivebase and arm models step right before the control task reads the sensors
+        scheduler_.addTask(
+            "Sim",
+            [&]
+            {
+                if (swerveSim_)
+                {
+                    swerveSim_->update();
+                }
+                if (armSim_)
+                {
+                    armSim_->update();
+                }
+            },
+            LoopConstants::CONTROL_PERIOD, 0);
+    }
 
-    AddPeriodic(
+    // Feedback at the fast rate, setpoints from auto and teleop at the slow rate. Both run on the robot loop thread.
+    scheduler_.addTask(
+        "Control",
         [&]
         {
-            double yaw = navx_->GetYaw() - yawOffset_/* + swerveDrive_->getYawTagOffset()*/;
-            Helpers::normalizeAngle(yaw);
-            frc::SmartDashboard::PutNumber("yaw", yaw);
-            frc::SmartDashboard::PutBoolean("navx alive", navx_->IsConnected());
-            frc::SmartDashboard::PutBoolean("Data Stale", socketClient_.IsStale());
-            frc::SmartDashboard::PutBoolean("Camera Connection", socketClient_.HasConn());
-
-            double ang = (yaw)*M_PI / 180.0;                                                                       // Radians
-            double pitch = Helpers::getPrincipalAng2Deg((double)navx_->GetPitch() + SwerveConstants::PITCHOFFSET); // Degrees
-            double roll = Helpers::getPrincipalAng2Deg((double)navx_->GetRoll() + SwerveConstants::ROLLOFFSET);    // Degrees
-            double tilt = pitch * sin(ang) - roll * cos(ang);
-            frc::SmartDashboard::PutNumber("Tilt", tilt);
-            frc::SmartDashboard::PutNumber("Pitch", pitch);
-            frc::SmartDashboard::PutNumber("Roll", roll);
+            sample();
+
+            {
+                ScopedTimer timer(swerveTimes_);
+                swerveDrive_->updateOdometry(snapshot_.yaw, snapshot_.time);
+                swerveDrive_->updateModules(snapshot_.time);
+            }
+
+            {
+                ScopedTimer timer(armTimes_);
+                arm_->periodic();
+            }
+        },
+        LoopConstants::CONTROL_PERIOD, LoopConstants::CONTROL_OFFSET);
+
+    scheduler_.addTask(
+        "Sequencing",
+        [&]
+        {
+            telemetry_.setTimestamp(frc::RobotController::GetFPGATime());
+
+            telemetry_.log(yawChannel_, snapshot_.yaw);
+            telemetry_.log(navxAliveChannel_, snapshot_.navxConnected);
+            telemetry_.log(dataStaleChannel_, snapshot_.visionStale);
+            telemetry_.log(cameraConnChannel_, snapshot_.visionConnected);
+            telemetry_.log(cameraStateChannel_, snapshot_.visionState);
+            telemetry_.log(tiltChannel_, snapshot_.tilt);
+            telemetry_.log(pitchChannel_, snapshot_.pitch);
+            telemetry_.log(rollChannel_, snapshot_.roll);
             // frc::SmartDashboard::PutNumber("Pitch Raw", navx_->GetPitch());
             // frc::SmartDashboard::PutNumber("Roll Raw", navx_->GetRoll());
 
-            vector<double> data = socketClient_.GetData();
-            swerveDrive_->periodic(yaw, tilt, data);
+            {
+                ScopedTimer timer(visionTimes_);
+                swerveDrive_->updateVision(snapshot_.tilt, snapshot_.visionData, snapshot_.time);
+            }
 
-            arm_->periodic();
-            cubeIntake_.Periodic();
+            {
+                ScopedTimer timer(intakeTimes_);
+                cubeIntake_.Periodic();
+            }
             arm_->updateIntakeStates(cubeIntake_.getState() == PneumaticsIntake::DEPLOYED, false); // TODO here for cone intake
 
             if (frc::DriverStation::IsAutonomous() && frc::DriverStation::IsEnabled())
             {
+                ScopedTimer timer(autoTimes_);
                 autoPaths_.periodic();
-                autoPaths_.setGyros(yaw, navx_->GetPitch(), navx_->GetRoll());
+                autoPaths_.setGyros(snapshot_.yaw, snapshot_.rawPitch, snapshot_.rawRoll);
             }
             else if (frc::DriverStation::IsTeleop())
             {
                 bool armMoving = (arm_->getState() != TwoJointArm::STOPPED && arm_->getState() != TwoJointArm::HOLDING_POS);
                 // bool armOut = (arm_->getPosition() != TwoJointArmProfiles::STOWED /* && arm_->getPosition() != TwoJointArmProfiles::CONE_INTAKE*/ && arm_->getPosition() != TwoJointArmProfiles::CUBE_INTAKE && arm_->getPosition() != TwoJointArmProfiles::GROUND);
                 bool armOut = (arm_->getPosition() == TwoJointArmProfiles::MID || arm_->getPosition() == TwoJointArmProfiles::HIGH || arm_->getPosition() == TwoJointArmProfiles::CUBE_MID || arm_->getPosition() == TwoJointArmProfiles::CUBE_HIGH); // TODO make this based on xy position
+                ScopedTimer timer(teleopDriveTimes_);
                 swerveDrive_->teleopPeriodic(controls_, arm_->isForward(), (armMoving || armOut), scoringLevel_);
             }
 
@@ -58,16 +145,66 @@ Robot::Robot() : autoPaths_(swerveDrive_, arm_), socketClient_("10.1.14.43", 580
             //     swerveDrive_->periodic(yaw, controls_, arm_->isForward(), armMoving);
             // }
         },
-        5_ms, 2_ms);
+        LoopConstants::SEQUENCING_PERIOD, LoopConstants::SEQUENCING_OFFSET);
+
+    scheduler_.registerTelemetry(telemetry_);
+}
+
+Robot::~Robot()
+{
+    Clock::setDefault(nullptr);
+}
+
+/**
+ * Reads every sensor the loop uses once, at the top of the loop, so each tick works off one consistent set of readings
+ */
+void Robot::sample()
+{
+    // The one clock read for the tick, everything downstream gets this time
+    snapshot_.time = fpgaClock_.getTime();
+    tickClock_.setTime(snapshot_.time);
+
+    snapshot_.navxConnected = navx_->IsConnected();
+    double yaw = navx_->GetYaw() - yawOffset_/* + swerveDrive_->getYawTagOffset()*/;
+    Helpers::normalizeAngle(yaw);
+    snapshot_.yaw = yaw;
+    snapshot_.rawPitch = navx_->GetPitch();
+    snapshot_.rawRoll = navx_->GetRoll();
+
+    double ang = (yaw)*M_PI / 180.0;                                                                         // Radians
+    snapshot_.pitch = Helpers::getPrincipalAng2Deg(snapshot_.rawPitch + SwerveConstants::PITCHOFFSET); // Degrees
+    snapshot_.roll = Helpers::getPrincipalAng2Deg(snapshot_.rawRoll + SwerveConstants::ROLLOFFSET);    // Degrees
+    snapshot_.tilt = snapshot_.pitch * sin(ang) - snapshot_.roll * cos(ang);
+
+    snapshot_.visionData = socketClient_.GetData();
+    snapshot_.visionStale = socketClient_.IsStale();
+    snapshot_.visionConnected = socketClient_.HasConn();
+    snapshot_.visionState = socketClient_.GetStateString();
+
+    snapshot_.arm = arm_->sample();
+    snapshot_.swerve = swerveDrive_->sample();
 }
 
 void Robot::RobotInit()
 {
+    // RobotInit runs on the thread that runs every loop after it, so this makes the whole control loop real time.
+    // Dashboards and logging only go through telemetry_, which hands off to its own background thread.
+    if (IsReal())
+    {
+        frc::Notifier::SetHALThreadPriority(true, ThreadConstants::NOTIFIER_PRIORITY);
+        if (!RealTime::makeCurrentThreadRealTime(ThreadConstants::CONTROL_PRIORITY, ThreadConstants::CONTROL_CORE))
+        {
+            frc::DataLogManager::Log("Couldn't make the control thread real time");
+        }
+    }
 
     // frc::SmartDashboard::PutBoolean("Sending it Fast", false);
     // frc::SmartDashboard::PutBoolean("Sending it Medium", false);
     // frc::SmartDashboard::PutBoolean("Balanced", false);
     socketClient_.Init();
+    telemetry_.start();
+    rioBus_.start();
+    drivebaseBus_.start();
     arm_->zeroArmsToAutoStow();
     cubeGrabber_.Stop();
 
@@ -182,6 +319,12 @@ void Robot::RobotInit()
         cout << e.what() << endl;
     }
     navx_->ZeroYaw();
+
+    if (IsSimulation())
+    {
+        swerveSim_ = std::make_unique<SwerveSim>(*swerveDrive_, frc::SerialPort::kUSB);
+        armSim_ = std::make_unique<ArmSim>(*arm_);
+    }
 }
 
 /**
@@ -196,30 +339,82 @@ void Robot::RobotPeriodic()
 {
     // frc::SmartDashboard::PutBoolean("Shoulder Brake", arm_->shoulderBrakeEngaged());
     // frc::SmartDashboard::PutBoolean("Elbow Brake", arm_->elbowBrakeEngaged());
-    frc::SmartDashboard::PutBoolean("Forward", arm_->isForward());
-    frc::SmartDashboard::PutBoolean("Pos Known", !arm_->posUnknown());
+    telemetry_.setTimestamp(frc::RobotController::GetFPGATime());
+    telemetry_.log(forwardChannel_, arm_->isForward());
+    telemetry_.log(posKnownChannel_, !arm_->posUnknown());
     // frc::SmartDashboard::PutBoolean("Intaking Cone", coneIntaking_);
-    frc::SmartDashboard::PutBoolean("Intaking Cube", cubeIntaking_);
-    frc::SmartDashboard::PutBoolean("ESTOPPED", arm_->isEStopped());
-    frc::SmartDashboard::PutBoolean("Arms Zeroed", armsZeroed_);
-
-    frc::SmartDashboard::PutString("Arm State", arm_->getStateString());
-    frc::SmartDashboard::PutString("Arm Pos", arm_->getPosString());
-    frc::SmartDashboard::PutString("Arm Set Pos", arm_->getSetPosString());
-
-    frc::SmartDashboard::PutNumber("x", swerveDrive_->getX());
-    frc::SmartDashboard::PutNumber("y", swerveDrive_->getY());
-    frc::SmartDashboard::PutNumber("Theta", arm_->getTheta());
-    frc::SmartDashboard::PutNumber("Phi", arm_->getPhi());
+    telemetry_.log(intakingCubeChannel_, cubeIntaking_);
+    telemetry_.log(eStoppedChannel_, arm_->isEStopped());
+    telemetry_.log(armsZeroedChannel_, armsZeroed_);
+
+    telemetry_.log(armStateChannel_, arm_->getStateString());
+    telemetry_.log(armPosChannel_, arm_->getPosString());
+    telemetry_.log(armSetPosChannel_, arm_->getSetPosString());
+
+    telemetry_.log(xChannel_, swerveDrive_->getX());
+    telemetry_.log(yChannel_, swerveDrive_->getY());
+    telemetry_.log(thetaChannel_, arm_->getTheta());
+    telemetry_.log(phiChannel_, arm_->getPhi());
     // frc::SmartDashboard::PutNumber("Theta vel", arm_->getThetaVel());
     // frc::SmartDashboard::PutNumber("Phi vel", arm_->getPhiVel());
     // frc::SmartDashboard::PutNumber("Theta Volts", arm_->getThetaVolts());
     // frc::SmartDashboard::PutNumber("Phi Volts", arm_->getPhiVolts());
 
-    frc::SmartDashboard::PutNumber("Scoring Pos", swerveDrive_->getScoringPos());
+    telemetry_.log(scoringPosChannel_, swerveDrive_->getScoringPos());
 
-    frc::SmartDashboard::PutBoolean("Cutout Intaking", cubeIntake_.getState() == CubeGrabber::INTAKING);
-    frc::SmartDashboard::PutBoolean("Cutout Outaking", cubeIntake_.getState() == CubeGrabber::OUTTAKING);
+    telemetry_.log(cutoutIntakingChannel_, cubeIntake_.getState() == CubeGrabber::INTAKING);
+    telemetry_.log(cutoutOutakingChannel_, cubeIntake_.getState() == CubeGrabber::OUTTAKING);
+
+    logTimes();
+    logSubsystems();
+}
+
+void Robot::logTimes()
+{
+    scheduler_.logTelemetry(telemetry_);
+    swerveTimes_.logTelemetry(telemetry_);
+    armTimes_.logTelemetry(telemetry_);
+    visionTimes_.logTelemetry(telemetry_);
+    intakeTimes_.logTelemetry(telemetry_);
+    autoTimes_.logTelemetry(telemetry_);
+    teleopDriveTimes_.logTelemetry(telemetry_);
+    socketClient_.GetParseTimes().logTelemetry(telemetry_);
+}
+
+/**
+ * Subsystem dashboard values, CAN frame health and bus utilization. Runs at the RobotPeriodic rate, not every control loop
+ */
+void Robot::logSubsystems()
+{
+    swerveDrive_->logTelemetry(telemetry_);
+    arm_->logTelemetry(telemetry_);
+    autoPaths_.logTelemetry(telemetry_);
+
+    rioBus_.logTelemetry(telemetry_);
+    drivebaseBus_.logTelemetry(telemetry_);
+}
+
+/**
+ * Prints the loop timing summaries to the console and the log, called when the robot gets disabled (end of match)
+ */
+void Robot::dumpTimes()
+{
+    if (scheduler_.getCount("Control") == 0)
+    {
+        return;
+    }
+
+    for (std::string summary : scheduler_.getSummaries())
+    {
+        frc::DataLogManager::Log(summary);
+    }
+    frc::DataLogManager::Log(swerveTimes_.getSummary());
+    frc::DataLogManager::Log(armTimes_.getSummary());
+    frc::DataLogManager::Log(visionTimes_.getSummary());
+    frc::DataLogManager::Log(intakeTimes_.getSummary());
+    frc::DataLogManager::Log(autoTimes_.getSummary());
+    frc::DataLogManager::Log(teleopDriveTimes_.getSummary());
+    frc::DataLogManager::Log(socketClient_.GetParseTimes().getSummary());
 }
 
 /**
@@ -235,6 +430,16 @@ void Robot::RobotPeriodic()
  */
 void Robot::AutonomousInit()
 {
+    // start of a match, only keep timing from this match
+    scheduler_.reset();
+    swerveTimes_.reset();
+    armTimes_.reset();
+    visionTimes_.reset();
+    intakeTimes_.reset();
+    autoTimes_.reset();
+    teleopDriveTimes_.reset();
+    socketClient_.GetParseTimes().reset();
+
     // arm_->stop();
     arm_->reset();
     arm_->setForward(true);
@@ -426,12 +631,7 @@ void Robot::TeleopPeriodic()
         // 90, 0, -
         // 180, +, 0
         // 270, 0, +
-        double yaw = (navx_->GetYaw() - yawOffset_/* + swerveDrive_->getYawTagOffset()*/);
-        Helpers::normalizeAngle(yaw);
-        double ang = (yaw)*M_PI / 180.0;                                                                       // Radians
-        double pitch = Helpers::getPrincipalAng2Deg((double)navx_->GetPitch() + SwerveConstants::PITCHOFFSET); // Degrees
-        double roll = Helpers::getPrincipalAng2Deg((double)navx_->GetRoll() + SwerveConstants::ROLLOFFSET);    // Degrees
-        double tilt = pitch * sin(ang) - roll * cos(ang);
+        double tilt = snapshot_.tilt;
         if (abs(tilt) < SwerveConstants::AUTODEADANGLE)
         {
             swerveDrive_->lockWheels();
@@ -538,8 +738,7 @@ void Robot::TeleopPeriodic()
             //     }
             // }
 
-            double yaw = navx_->GetYaw() - yawOffset_/* + swerveDrive_->getYawTagOffset()*/;
-            Helpers::normalizeAngle(yaw);
+            double yaw = snapshot_.yaw;
             if ((yaw) > 0) //HERE
             {
                 wantedYaw = 90;
@@ -1207,13 +1406,14 @@ void Robot::TeleopPeriodic()
         // STOW CONE INTAKE
     }
 
-    frc::SmartDashboard::PutBoolean("Cube Intake Down", intakesNeededDown.first);
+    telemetry_.log(cubeIntakeDownChannel_, intakesNeededDown.first);
     // frc::SmartDashboard::PutBoolean("Cone Intake Down", intakesNeededDown.second || coneIntakeDown_);
     // frc::SmartDashboard::PutBoolean("Cone Intake Halfway", coneIntakeHalfway);
 }
 
 void Robot::DisabledInit()
 {
+    dumpTimes();
     arm_->stop();
     autoPaths_.setActionsSet(false);
     autoPaths_.setPathSet(false);
@@ -1223,7 +1423,6 @@ void Robot::DisabledInit()
 
 void Robot::DisabledPeriodic()
 {
-    frc::SmartDashboard::PutNumber("Theta", arm_->getTheta());
     swerveDrive_->reset();
     autoPaths_.setActionsSet(false);
     autoPaths_.setPathSet(false);
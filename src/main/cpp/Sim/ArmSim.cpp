@@ -0,0 +1,288 @@
+#include "Sim/ArmSim.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <frc/RobotController.h>
+#include <frc/simulation/SimDeviceSim.h>
+
+/**
+ * Starts the arm in auto stow, where it sits at the start of a match
+ *
+ * @param arm The arm to simulate, its motor, encoder and brake sim values get used from here
+ */
+ArmSim::ArmSim(TwoJointArm &arm) : arm_(arm), hasCone_(false), prevTime_(-1)
+{
+    shoulderSign_ = arm_.shoulderMaster_.GetInverted() ? -1 : 1;
+    elbowSign_ = arm_.elbowMaster_.GetInverted() ? -1 : 1;
+
+    frc::sim::SimDeviceSim encoder("DutyCycle:DutyCycleEncoder", TwoJointArmConstants::SHOULDER_ENCODER_ID);
+    encoderPos_ = encoder.GetDouble("absPosition");
+
+    reset(TwoJointArmConstants::ARM_POSITIONS[TwoJointArmConstants::AUTO_STOW_NUM][2], TwoJointArmConstants::ARM_POSITIONS[TwoJointArmConstants::AUTO_STOW_NUM][3]);
+}
+
+/**
+ * Puts the arm somewhere, stopped, and zeros the motor encoders there like zeroArms() would
+ *
+ * @param theta, phi Degrees, forward convention
+ */
+void ArmSim::reset(double theta, double phi)
+{
+    theta_ = theta * M_PI / 180;
+    phi_ = phi * M_PI / 180;
+    thetaVel_ = 0;
+    phiVel_ = 0;
+    shoulderCurrent_ = 0;
+    elbowCurrent_ = 0;
+    shoulderPos_ = 0;
+    elbowPos_ = 0;
+    writeSensors();
+
+    arm_.shoulderMaster_.SetSelectedSensorPosition(theta * 2048 / 360.0 / TwoJointArmConstants::MOTOR_TO_SHOULDER_RATIO);
+    arm_.elbowMaster_.SetSelectedSensorPosition((phi + theta * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO) * 2048 / 360.0 / TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO / TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
+    arm_.sample();
+}
+
+/**
+ * Steps by however long it's been since the last call, run it right before the control task
+ */
+void ArmSim::update()
+{
+    double time = frc::RobotController::GetFPGATime() / 1000000.0;
+    if (prevTime_ >= 0)
+    {
+        step(time - prevTime_);
+    }
+    prevTime_ = time;
+}
+
+/**
+ * Steps the model by dt seconds, in substeps short enough for the shoulder to stay stable
+ */
+void ArmSim::step(double dt)
+{
+    if (dt <= 0)
+    {
+        return;
+    }
+
+    int substeps = std::ceil(dt / TwoJointArmConstants::SIM_SUBSTEP);
+    double h = dt / substeps;
+    for (int i = 0; i < substeps; i++)
+    {
+        substep(h);
+    }
+
+    writeSensors();
+}
+
+void ArmSim::setCone(bool hasCone)
+{
+    hasCone_ = hasCone;
+}
+
+/**
+ * Falcon torque at the rotor
+ *
+ * @param volts Applied voltage
+ * @param rotorSpeed rad/s
+ */
+double ArmSim::motorTorque(double volts, double rotorSpeed)
+{
+    return motorCurrent(volts, rotorSpeed) / GeneralConstants::Kv;
+}
+
+/**
+ * Stator current of a Falcon
+ */
+double ArmSim::motorCurrent(double volts, double rotorSpeed)
+{
+    return (volts - rotorSpeed / GeneralConstants::Kv) / GeneralConstants::RESISTANCE;
+}
+
+void ArmSim::substep(double dt)
+{
+    using namespace TwoJointArmConstants;
+
+    // Rotor rad per joint rad. The elbow motors turn with phi and with the shoulder, see getPhi()
+    double shoulderRatio = 1 / MOTOR_TO_SHOULDER_RATIO;
+    double elbowRatioTheta = 1 / MOTOR_TO_ELBOW_RATIO;
+    double elbowRatioPhi = 1 / (MOTOR_TO_ELBOW_RATIO * SHOULDER_TO_ELBOW_RATIO);
+
+    // Links, with the cone at the end of the claw
+    double coneM = hasCone_ ? GeneralConstants::CONE_M : 0;
+    double coneDist = FOREARM_LENGTH + EE_LENGTH;
+    double forearmMoment = FOREARM_M * FOREARM_COM_DIST + coneM * coneDist;
+    double coupling = forearmMoment * UPPER_ARM_LENGTH;
+
+    // Mass matrix with both links' angles from straight up, a1 = theta and a2 = theta + phi
+    double m11 = UPPER_ARM_I + UPPER_ARM_M * UPPER_ARM_COM_DIST * UPPER_ARM_COM_DIST + (FOREARM_M + coneM) * UPPER_ARM_LENGTH * UPPER_ARM_LENGTH;
+    double m22 = FOREARM_I + FOREARM_M * FOREARM_COM_DIST * FOREARM_COM_DIST + coneM * coneDist * coneDist;
+    double m12 = coupling * cos(phi_);
+
+    // Gravity (pushes the links away from straight up, like calc*GravityTorque) and the velocity product terms
+    double a1Vel = thetaVel_;
+    double a2Vel = thetaVel_ + phiVel_;
+    double f1 = GeneralConstants::g * (UPPER_ARM_M * UPPER_ARM_COM_DIST + (FOREARM_M + coneM) * UPPER_ARM_LENGTH) * sin(theta_) + coupling * sin(phi_) * a2Vel * a2Vel;
+    double f2 = GeneralConstants::g * forearmMoment * sin(theta_ + phi_) - coupling * sin(phi_) * a1Vel * a1Vel;
+
+    // Over to theta and phi
+    double mtt = m11 + 2 * m12 + m22;
+    double mtp = m12 + m22;
+    double mpp = m22;
+    double ft = f1 + f2;
+    double fp = f2;
+
+    // Reflected rotor inertia
+    double rotorI = SIM_MOTORS_PER_JOINT * SIM_ROTOR_MOI;
+    mtt += rotorI * (shoulderRatio * shoulderRatio + elbowRatioTheta * elbowRatioTheta);
+    mtp += rotorI * elbowRatioTheta * elbowRatioPhi;
+    mpp += rotorI * elbowRatioPhi * elbowRatioPhi;
+
+    // Motors, both on each joint get the same output
+    TalonFXSimCollection &shoulderSim = arm_.shoulderMaster_.GetSimCollection();
+    TalonFXSimCollection &elbowSim = arm_.elbowMaster_.GetSimCollection();
+    shoulderSim.SetBusVoltage(GeneralConstants::MAX_VOLTAGE);
+    elbowSim.SetBusVoltage(GeneralConstants::MAX_VOLTAGE);
+
+    double shoulderVolts = shoulderSign_ * shoulderSim.GetMotorOutputLeadVoltage();
+    double shoulderRotorSpeed = shoulderRatio * thetaVel_;
+    double shoulderTorque = SIM_MOTORS_PER_JOINT * motorTorque(shoulderVolts, shoulderRotorSpeed);
+    shoulderCurrent_ = std::abs(motorCurrent(shoulderVolts, shoulderRotorSpeed) * shoulderVolts / GeneralConstants::MAX_VOLTAGE);
+
+    double elbowVolts = elbowSign_ * elbowSim.GetMotorOutputLeadVoltage();
+    double elbowRotorSpeed = elbowRatioTheta * thetaVel_ + elbowRatioPhi * phiVel_;
+    double elbowTorque = SIM_MOTORS_PER_JOINT * motorTorque(elbowVolts, elbowRotorSpeed);
+    elbowCurrent_ = std::abs(motorCurrent(elbowVolts, elbowRotorSpeed) * elbowVolts / GeneralConstants::MAX_VOLTAGE);
+
+    ft += shoulderTorque * shoulderRatio + elbowTorque * elbowRatioTheta;
+    fp += elbowTorque * elbowRatioPhi;
+
+    ft -= SIM_SHOULDER_FRICTION * thetaVel_ / (std::abs(thetaVel_) + SIM_FRICTION_VEL);
+    fp -= SIM_ELBOW_FRICTION * phiVel_ / (std::abs(phiVel_) + SIM_FRICTION_VEL);
+
+    // A brake holds its gearbox still, so only what's left free gets solved for
+    bool shoulderHeld = shoulderBraked();
+    bool elbowHeld = elbowBraked();
+    if (shoulderHeld && elbowHeld)
+    {
+        thetaVel_ = 0;
+        phiVel_ = 0;
+    }
+    else if (shoulderHeld)
+    {
+        thetaVel_ = 0;
+        phiVel_ += fp / mpp * dt;
+    }
+    else if (elbowHeld)
+    {
+        // Elbow rotor held means phi moves against the shoulder, direction (1, -SHOULDER_TO_ELBOW_RATIO)
+        double d = -SHOULDER_TO_ELBOW_RATIO;
+        double m = mtt + 2 * mtp * d + mpp * d * d;
+        thetaVel_ += (ft + fp * d) / m * dt;
+        phiVel_ = d * thetaVel_;
+    }
+    else
+    {
+        double det = mtt * mpp - mtp * mtp;
+        double thetaAcc = (mpp * ft - mtp * fp) / det;
+        double phiAcc = (mtt * fp - mtp * ft) / det;
+        thetaVel_ += thetaAcc * dt;
+        phiVel_ += phiAcc * dt;
+    }
+
+    theta_ += thetaVel_ * dt;
+    phi_ += phiVel_ * dt;
+
+    // Hard stops, anything going into one stops dead
+    double thetaMin = (SHOULDER_MIN_ANG - SIM_HARD_STOP_MARGIN) * M_PI / 180;
+    double thetaMax = (SHOULDER_MAX_ANG + SIM_HARD_STOP_MARGIN) * M_PI / 180;
+    double phiMin = (ELBOW_MIN_ANG - SIM_HARD_STOP_MARGIN) * M_PI / 180;
+    double phiMax = (ELBOW_MAX_ANG + SIM_HARD_STOP_MARGIN) * M_PI / 180;
+    if ((theta_ <= thetaMin && thetaVel_ < 0) || (theta_ >= thetaMax && thetaVel_ > 0))
+    {
+        theta_ = std::clamp(theta_, thetaMin, thetaMax);
+        thetaVel_ = 0;
+    }
+    if ((phi_ <= phiMin && phiVel_ < 0) || (phi_ >= phiMax && phiVel_ > 0))
+    {
+        phi_ = std::clamp(phi_, phiMin, phiMax);
+        phiVel_ = 0;
+    }
+
+    shoulderPos_ += shoulderSign_ * shoulderRatio * thetaVel_ * dt * GeneralConstants::TICKS_PER_ROTATION / (2 * M_PI);
+    elbowPos_ += elbowSign_ * (elbowRatioTheta * thetaVel_ + elbowRatioPhi * phiVel_) * dt * GeneralConstants::TICKS_PER_ROTATION / (2 * M_PI);
+}
+
+/**
+ * Writes the state into the talons and the shoulder encoder, what the arm reads in sample()
+ */
+void ArmSim::writeSensors()
+{
+    double ticksPerRad = GeneralConstants::TICKS_PER_ROTATION / (2 * M_PI);
+
+    // position as a change, so the motors keep the position they got zeroed to
+    TalonFXSimCollection &shoulderSim = arm_.shoulderMaster_.GetSimCollection();
+    double shoulderRotorSpeed = thetaVel_ / TwoJointArmConstants::MOTOR_TO_SHOULDER_RATIO;
+    shoulderSim.SetIntegratedSensorVelocity((int)(shoulderSign_ * shoulderRotorSpeed * ticksPerRad / 10));
+    int shoulderTicks = (int)shoulderPos_;
+    shoulderSim.AddIntegratedSensorPosition(shoulderTicks);
+    shoulderPos_ -= shoulderTicks;
+    shoulderSim.SetSupplyCurrent(shoulderCurrent_);
+
+    TalonFXSimCollection &elbowSim = arm_.elbowMaster_.GetSimCollection();
+    double elbowRotorSpeed = thetaVel_ / TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO + phiVel_ / (TwoJointArmConstants::MOTOR_TO_ELBOW_RATIO * TwoJointArmConstants::SHOULDER_TO_ELBOW_RATIO);
+    elbowSim.SetIntegratedSensorVelocity((int)(elbowSign_ * elbowRotorSpeed * ticksPerRad / 10));
+    int elbowTicks = (int)elbowPos_;
+    elbowSim.AddIntegratedSensorPosition(elbowTicks);
+    elbowPos_ -= elbowTicks;
+    elbowSim.SetSupplyCurrent(elbowCurrent_);
+
+    // getTheta() is -(rotations * 360) + SHOULDER_ENCODER_OFFSET
+    double rotations = (TwoJointArmConstants::SHOULDER_ENCODER_OFFSET - getTheta()) / 360;
+    rotations -= std::floor(rotations);
+    if (encoderPos_)
+    {
+        encoderPos_.Set(rotations);
+    }
+}
+
+/**
+ * In degrees, forward convention
+ */
+double ArmSim::getTheta()
+{
+    return theta_ * 180 / M_PI;
+}
+
+double ArmSim::getPhi()
+{
+    return phi_ * 180 / M_PI;
+}
+
+/**
+ * In deg/s
+ */
+double ArmSim::getThetaVel()
+{
+    return thetaVel_ * 180 / M_PI;
+}
+
+double ArmSim::getPhiVel()
+{
+    return phiVel_ * 180 / M_PI;
+}
+
+/**
+ * The brakes are on when their solenoids are off, see TwoJointArm::setBrakes()
+ */
+bool ArmSim::shoulderBraked()
+{
+    return !arm_.shoulderBrake_.Get();
+}
+
+bool ArmSim::elbowBraked()
+{
+    return !arm_.elbowBrake_.Get();
+}
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <poll.h>
+#include <sstream>
+#include <strings.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <frc/RobotController.h>
+
+#include "Sim/FakeCoprocessor.h"
+
+FakeCoprocessor::FakeCoprocessor(int port, Config config)
+    : port_(port), config_(config), stopFd_(-1), hasClient_(false), rng_(config.seed), startTime_(0), nextCaptureTime_(0),
+      lastSendTime_(0), dropsLeft_(0), count_(0), numDropped_(0)
+{
+    clockUs_ = []
+    { return frc::RobotController::GetFPGATime(); };
+}
+
+FakeCoprocessor::~FakeCoprocessor()
+{
+    stop();
+}
+
+/**
+ * Sets what the camera sees. The source gets the capture time in seconds on the rio clock.
+ */
+void FakeCoprocessor::setSource(DetectionSource source)
+{
+    source_ = source;
+}
+
+/**
+ * Replays a recorded detection stream, csv lines of time,camId,tagId,x,y,angZ with time in seconds
+ * from when the client connects. Lines that don't parse (like a header) are skipped.
+ *
+ * @param filePath The recording
+ * @param loop Whether to start over after the last detection
+ * @returns If anything was loaded
+ */
+bool FakeCoprocessor::loadRecording(std::string filePath, bool loop)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    auto recording = std::make_shared<std::map<double, Detection>>();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        double time;
+        Detection detection;
+        if (sscanf(line.c_str(), "%lf,%d,%d,%lf,%lf,%lf", &time, &detection.camId, &detection.tagId, &detection.x, &detection.y, &detection.angZ) == 6)
+        {
+            (*recording)[time] = detection;
+        }
+    }
+    if (recording->empty())
+    {
+        return false;
+    }
+
+    double length = recording->rbegin()->first;
+    source_ = [this, recording, loop, length](double time, Detection &detection)
+    {
+        double t = time - startTime_ / 1000000.0;
+        if (loop && length > 0)
+        {
+            t = fmod(t, length);
+        }
+
+        auto it = recording->upper_bound(t);
+        if (it == recording->begin())
+        {
+            return false;
+        }
+        --it;
+        // gap in the recording, nothing in view
+        if (t - it->first > 2.0 / config_.rate)
+        {
+            return false;
+        }
+        detection = it->second;
+        return true;
+    };
+    return true;
+}
+
+/**
+ * Sets the rio clock, in us. Defaults to the FPGA clock so it follows sim timing.
+ */
+void FakeCoprocessor::setClock(std::function<uint64_t()> clockUs)
+{
+    clockUs_ = clockUs;
+}
+
+void FakeCoprocessor::start()
+{
+    if (thread_.joinable())
+    {
+        return;
+    }
+
+    stopFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    thread_ = std::thread([this]
+                          { loop(); });
+}
+
+void FakeCoprocessor::stop()
+{
+    if (!thread_.joinable())
+    {
+        return;
+    }
+
+    uint64_t one = 1;
+    write(stopFd_, &one, sizeof(one));
+    thread_.join();
+
+    close(stopFd_);
+    stopFd_ = -1;
+}
+
+bool FakeCoprocessor::hasClient()
+{
+    return hasClient_.load();
+}
+
+int FakeCoprocessor::getNumSent()
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return sentFrames_.size();
+}
+
+int FakeCoprocessor::getNumDropped()
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return numDropped_;
+}
+
+/**
+ * Gets every detection sent so far, with its true capture time to check the client's timestamps against
+ */
+std::vector<FakeCoprocessor::SentFrame> FakeCoprocessor::getSentFrames()
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return sentFrames_;
+}
+
+void FakeCoprocessor::loop()
+{
+    int listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    bzero(&addr, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port_);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listenFd, 1) != 0)
+    {
+        perror("FakeCoprocessor");
+        close(listenFd);
+        return;
+    }
+
+    int clientFd = -1;
+    std::string pending;
+    while (true)
+    {
+        if (clientFd == -1)
+        {
+            struct pollfd pfds[2] = {{listenFd, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+            poll(pfds, 2, -1);
+            if (pfds[1].revents & POLLIN)
+            {
+                break;
+            }
+
+            clientFd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (clientFd != -1)
+            {
+                pending.clear();
+                pendingFrames_.clear();
+                startTime_ = clockUs_();
+                nextCaptureTime_ = startTime_;
+                lastSendTime_ = startTime_;
+                hasClient_.store(true);
+            }
+            continue;
+        }
+
+        // 1 ms keeps send times accurate without busy waiting, the clock may be sim time so can't sleep until the next frame
+        struct pollfd pfds[2] = {{clientFd, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+        int ready = poll(pfds, 2, 1);
+        if (ready > 0 && (pfds[1].revents & POLLIN))
+        {
+            break;
+        }
+
+        bool closed = false;
+        if (ready > 0 && (pfds[0].revents & (POLLIN | POLLERR | POLLHUP)))
+        {
+            char buff[128];
+            ssize_t n;
+            while ((n = read(clientFd, buff, sizeof(buff))) > 0)
+            {
+                pending.append(buff, n);
+            }
+            closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+            handlePings(clientFd, pending);
+        }
+
+        uint64_t now = clockUs_();
+        while (nextCaptureTime_ <= now)
+        {
+            queueFrame(nextCaptureTime_);
+            nextCaptureTime_ += (uint64_t)(1000000 / config_.rate);
+        }
+        sendDueFrames(clientFd, now);
+
+        if (closed)
+        {
+            close(clientFd);
+            clientFd = -1;
+            hasClient_.store(false);
+        }
+    }
+
+    if (clientFd != -1)
+    {
+        close(clientFd);
+    }
+    close(listenFd);
+    hasClient_.store(false);
+}
+
+/**
+ * Answers every complete ?seq,t0 line with !seq,t0,t1,t2$ where t1 and t2 are on the jetson clock
+ */
+void FakeCoprocessor::handlePings(int clientFd, std::string &pending)
+{
+    size_t end;
+    while ((end = pending.find('\n')) != std::string::npos)
+    {
+        unsigned long long seq;
+        long long t0;
+        if (sscanf(pending.c_str(), "?%llu,%lld", &seq, &t0) == 2)
+        {
+            long long jetsonTime = clockUs_() + (long long)(config_.clockOffset * 1000000);
+            std::string pong = "!" + std::to_string(seq) + "," + std::to_string(t0) + "," + std::to_string(jetsonTime) + "," + std::to_string(jetsonTime) + "$";
+            send(clientFd, pong.c_str(), pong.size(), MSG_NOSIGNAL);
+        }
+        pending.erase(0, end + 1);
+    }
+}
+
+/**
+ * Captures a frame at the given time and schedules it to be sent after the latency, unless it gets dropped
+ */
+void FakeCoprocessor::queueFrame(uint64_t captureTime)
+{
+    if (dropsLeft_ > 0 || std::uniform_real_distribution<double>(0, 1)(rng_) < config_.dropChance)
+    {
+        dropsLeft_ = (dropsLeft_ > 0 ? dropsLeft_ : config_.dropBurst) - 1;
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        numDropped_++;
+        return;
+    }
+
+    // -1 tag is nothing in view, sent as a heartbeat
+    Detection detection{-1, -1, 0, 0, 0};
+    if (source_ && !source_(captureTime / 1000000.0, detection))
+    {
+        detection = {-1, -1, 0, 0, 0};
+    }
+
+    double latency = config_.latency;
+    if (config_.jitter > 0)
+    {
+        latency += std::uniform_real_distribution<double>(-config_.jitter, config_.jitter)(rng_);
+    }
+    // frames go out over one stream, so they can't pass each other
+    uint64_t sendTime = std::max(lastSendTime_, captureTime + (uint64_t)(std::max(latency, 0.0) * 1000000));
+    lastSendTime_ = sendTime;
+
+    pendingFrames_.push_back({detection, captureTime, sendTime});
+}
+
+void FakeCoprocessor::sendDueFrames(int clientFd, uint64_t now)
+{
+    size_t numDue = 0;
+    for (; numDue < pendingFrames_.size() && pendingFrames_[numDue].sendTime <= now; numDue++)
+    {
+        PendingFrame &frame = pendingFrames_[numDue];
+        if (frame.detection.tagId == -1)
+        {
+            send(clientFd, "0", 1, MSG_NOSIGNAL);
+            continue;
+        }
+
+        count_++;
+        std::ostringstream msg;
+        msg << "^" << frame.detection.camId << "," << frame.detection.tagId << "," << frame.detection.x << "," << frame.detection.y << ","
+            << frame.detection.angZ << "," << (frame.sendTime - frame.captureTime) / 1000 << "," << count_;
+        if (config_.sendCaptureTime)
+        {
+            msg << "," << (long long)frame.captureTime + (long long)(config_.clockOffset * 1000000);
+        }
+        msg << "$";
+        std::string str = msg.str();
+        send(clientFd, str.c_str(), str.size(), MSG_NOSIGNAL);
+
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        sentFrames_.push_back({count_, frame.captureTime, frame.sendTime});
+    }
+    pendingFrames_.erase(pendingFrames_.begin(), pendingFrames_.begin() + numDue);
+}
@@ -0,0 +1,438 @@
+#include <wpi/DataLogReader.h>
+#include <wpi/MemoryBuffer.h>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <fmt/format.h>
+
+#include "Sim/LogAnalyzer.h"
+
+LogAnalyzer::LogAnalyzer() : print_(false) {
+    default_ = {DEFAULT_VALUE_TOLERANCE, 0, DEFAULT_TIME_TOLERANCE, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+}
+
+/**
+ * Reads and indexes the expected trace
+ *
+ * @return "" if it loaded, what went wrong if not
+ */
+std::string LogAnalyzer::loadExpected(std::string fileName) {
+    std::ifstream expectedLog(fileName);
+    if (!expectedLog.is_open()) {
+        return "could not open expected log file\n";
+    }
+
+    std::string line;
+    if (!std::getline(expectedLog, line)) {
+        return "expected log file too short\n";
+    }
+
+    channels_.clear();
+    names_.clear();
+    std::stringstream header(line);
+    std::string name;
+    while (std::getline(header, name, ',')) {
+        channels_[name] = Channel{default_, false, {}, {}, 0, 0, 0, 0, false, 0, "", ""};
+        names_.push_back(name);
+    }
+
+    while (std::getline(expectedLog, line)) {
+        if (line.rfind("#", 0) == 0) {
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, ',')) {
+                fields.push_back(field);
+            }
+
+            if (fields[0] == "#default") {
+                if (!parseTolerance(fields, 1, default_)) {
+                    return "bad tolerance: " + line + "\n";
+                }
+                for (auto &channel : channels_) {
+                    if (!channel.second.customTolerance) {
+                        channel.second.tolerance = default_;
+                    }
+                }
+            } else if (fields[0] == "#channel" && fields.size() > 1) {
+                auto channel = channels_.find(fields[1]);
+                if (channel == channels_.end()) {
+                    return "tolerance for a channel that isn't watched: " + line + "\n";
+                }
+                if (!parseTolerance(fields, 2, channel->second.tolerance)) {
+                    return "bad tolerance: " + line + "\n";
+                }
+                channel->second.customTolerance = true;
+            }
+            continue;
+        }
+
+        size_t first = line.find(',');
+        size_t second = first == std::string::npos ? std::string::npos : line.find(',', first + 1);
+        if (second == std::string::npos) {
+            continue;
+        }
+
+        auto channel = channels_.find(line.substr(first + 1, second - first - 1));
+        if (channel == channels_.end()) {
+            continue;
+        }
+        std::string text = line.substr(second + 1);
+        channel->second.expected.push_back({std::strtod(line.c_str(), nullptr), parseNumber(text), text});
+    }
+
+    for (auto &channel : channels_) {
+        std::vector<Sample> &expected = channel.second.expected;
+        std::stable_sort(expected.begin(), expected.end(), [](const Sample &a, const Sample &b) { return a.time < b.time; });
+    }
+
+    return "";
+}
+
+/**
+ * Goes through the log once, comparing every watched sample
+ *
+ * @return "" if it matched, the report if not
+ */
+std::string LogAnalyzer::analyze(std::string logFileName) {
+    std::error_code ec;
+    std::unique_ptr<wpi::MemoryBuffer> buffer = wpi::MemoryBuffer::GetFile(logFileName, ec);
+    if (ec) {
+        return "could not open file: " + ec.message() + "\n";
+    }
+    wpi::log::DataLogReader reader{std::move(buffer)};
+    if (!reader) {
+        return "not a log file\n";
+    }
+
+    if (!debugFileName_.empty()) {
+        debugFile_.open(debugFileName_);
+        if (!debugFile_.is_open()) {
+            return "could not open debug log file\n";
+        }
+    }
+    bool format = print_ || debugFile_.is_open();
+
+    for (auto &entry : channels_) {
+        Channel &channel = entry.second;
+        channel.matched.assign(channel.expected.size(), false);
+        channel.count = 0;
+        channel.failures = 0;
+        channel.maxError = 0;
+        channel.maxErrorTime = 0;
+        channel.diverged = false;
+    }
+
+    int64_t startTime = 0;
+    int startEntry = -1;
+    std::unordered_map<int, Entry> entries;
+    for (auto &&record : reader) {
+        if (record.IsStart()) {
+            wpi::log::StartRecordData data;
+            if (!record.GetStartData(&data)) {
+                continue;
+            }
+            if (print_) {
+                fmt::print("Start({}, name='{}', type='{}') [{}]\n", data.entry, data.name, data.type, record.GetTimestamp() / 1000000.0);
+            }
+            if (data.name == "/simtesting/loginfo") {
+                startEntry = data.entry;
+            }
+            auto channel = channels_.find(std::string(data.name));
+            entries[data.entry] = Entry{std::string(data.name), std::string(data.type), kindOf(data.type), channel == channels_.end() ? nullptr : &channel->second};
+            continue;
+        }
+        if (record.IsFinish()) {
+            int entry;
+            if (record.GetFinishEntry(&entry)) {
+                entries.erase(entry);
+            }
+            continue;
+        }
+        if (record.IsControl()) {
+            continue;
+        }
+
+        if (record.GetEntry() == startEntry) {
+            std::string_view val;
+            if (record.GetString(&val) && val == "START") {
+                startTime = record.GetTimestamp();
+            }
+            continue;
+        }
+
+        auto it = entries.find(record.GetEntry());
+        if (it == entries.end() || (!it->second.channel && !format)) {
+            continue;
+        }
+        Entry &entry = it->second;
+        double time = (record.GetTimestamp() - startTime) / 1000000.0;
+
+        double value = std::numeric_limits<double>::quiet_NaN();
+        std::string text;
+        bool valid = true;
+        switch (entry.kind) {
+        case DOUBLE:
+            valid = record.GetDouble(&value);
+            break;
+        case INTEGER: {
+            int64_t val;
+            valid = record.GetInteger(&val);
+            value = val;
+            break;
+        }
+        case BOOLEAN: {
+            bool val;
+            valid = record.GetBoolean(&val);
+            value = val;
+            break;
+        }
+        case STRING: {
+            std::string_view val;
+            valid = record.GetString(&val);
+            text = val;
+            break;
+        }
+        case OTHER:
+            if (entry.type == "double[]") {
+                std::vector<double> val;
+                valid = record.GetDoubleArray(&val);
+                text = fmt::format("{}", fmt::join(val, "|"));
+            } else if (entry.type == "float[]") {
+                std::vector<float> val;
+                valid = record.GetFloatArray(&val);
+                text = fmt::format("{}", fmt::join(val, "|"));
+            } else if (entry.type == "int64[]") {
+                std::vector<int64_t> val;
+                valid = record.GetIntegerArray(&val);
+                text = fmt::format("{}", fmt::join(val, "|"));
+            } else if (entry.type == "boolean[]") {
+                std::vector<int> val;
+                valid = record.GetBooleanArray(&val);
+                text = fmt::format("{}", fmt::join(val, "|"));
+            } else if (entry.type == "string[]") {
+                std::vector<std::string_view> val;
+                valid = record.GetStringArray(&val);
+                text = fmt::format("{}", fmt::join(val, "|"));
+            } else {
+                valid = false;
+            }
+            break;
+        }
+        if (!valid) {
+            continue;
+        }
+
+        if (format) {
+            if (text.empty() && !std::isnan(value)) {
+                text = entry.kind == BOOLEAN ? (value != 0 ? "true" : "false") : fmt::format("{}", value);
+            }
+            std::string line = fmt::format("{:.2f},{},{}", time, entry.name, text);
+            if (print_) {
+                fmt::print("{}\n", line);
+            }
+            if (debugFile_.is_open()) {
+                debugFile_ << line << "\n";
+            }
+        }
+
+        if (entry.channel) {
+            compare(*entry.channel, time, value, text);
+        }
+    }
+
+    if (debugFile_.is_open()) {
+        debugFile_.close();
+    }
+
+    // Anything expected that nothing came close to
+    bool passed = true;
+    for (auto &entry : channels_) {
+        Channel &channel = entry.second;
+        for (size_t i = 0; i < channel.expected.size(); i++) {
+            const Sample &expected = channel.expected[i];
+            if (!channel.matched[i] && expected.time >= channel.tolerance.from && expected.time <= channel.tolerance.to) {
+                channel.failures++;
+                diverge(channel, expected.time, "nothing", expected.text);
+            }
+        }
+        passed = passed && channel.failures == 0;
+    }
+
+    return passed ? "" : getReport();
+}
+
+/**
+ * One line per watched channel, with how many samples were off, where it first went wrong and the largest error
+ */
+std::string LogAnalyzer::getReport() {
+    std::string report;
+    for (const std::string &name : names_) {
+        const Channel &channel = channels_[name];
+        if (channel.failures == 0) {
+            report += fmt::format("{}: ok, {} samples, max error {} at {:.2f} s\n", name, channel.count, channel.maxError, channel.maxErrorTime);
+        } else {
+            report += fmt::format("{}: {} off of {} samples, first at {:.2f} s ({}, expected {}), max error {} at {:.2f} s\n", name, channel.failures, channel.count,
+                                  channel.divergeTime, channel.divergeActual, channel.divergeExpected, channel.maxError, channel.maxErrorTime);
+        }
+    }
+    return report;
+}
+
+/**
+ * Prints every record as it goes by, slow on big logs
+ */
+void LogAnalyzer::setPrint(bool print) {
+    print_ = print;
+}
+
+/**
+ * Writes every record as "time,name,value", empty for none
+ */
+void LogAnalyzer::setDebugFile(std::string fileName) {
+    debugFileName_ = fileName;
+}
+
+/**
+ * Sets the default tolerance, for the channels the expected file doesn't set one for
+ *
+ * @param value Largest difference in a numeric value that still matches
+ * @param time Largest difference in seconds between when a sample was expected and when it came
+ */
+void LogAnalyzer::setTolerance(double value, double time) {
+    default_.abs = value;
+    default_.rel = 0;
+    default_.window = time;
+    for (auto &channel : channels_) {
+        if (!channel.second.customTolerance) {
+            channel.second.tolerance = default_;
+        }
+    }
+}
+
+LogAnalyzer::Type LogAnalyzer::kindOf(std::string_view type) {
+    if (type == "double" || type == "float") {
+        return DOUBLE;
+    } else if (type == "int64") {
+        return INTEGER;
+    } else if (type == "boolean") {
+        return BOOLEAN;
+    } else if (type == "string" || type == "json") {
+        return STRING;
+    }
+    return OTHER;
+}
+
+/**
+ * @return The number, or NaN if it isn't one. Booleans are 1 and 0.
+ */
+double LogAnalyzer::parseNumber(std::string_view text) {
+    if (text == "true") {
+        return 1;
+    } else if (text == "false") {
+        return 0;
+    }
+
+    std::string s(text);
+    char *end;
+    double value = std::strtod(s.c_str(), &end);
+    if (s.empty() || *end != '\0') {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return value;
+}
+
+/**
+ * Reads "key=value" fields (abs, rel, window, from, to) into tolerance, leaving out the ones that aren't there
+ */
+bool LogAnalyzer::parseTolerance(const std::vector<std::string> &fields, size_t first, Tolerance &tolerance) {
+    for (size_t i = first; i < fields.size(); i++) {
+        size_t equals = fields[i].find('=');
+        if (equals == std::string::npos) {
+            return false;
+        }
+        std::string key = fields[i].substr(0, equals);
+        double value = parseNumber(fields[i].substr(equals + 1));
+        if (std::isnan(value)) {
+            return false;
+        }
+
+        if (key == "abs") {
+            tolerance.abs = value;
+        } else if (key == "rel") {
+            tolerance.rel = value;
+        } else if (key == "window") {
+            tolerance.window = value;
+        } else if (key == "from") {
+            tolerance.from = value;
+        } else if (key == "to") {
+            tolerance.to = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Finds the closest expected sample within the window and keeps track of the error
+ */
+void LogAnalyzer::compare(Channel &channel, double time, double value, std::string_view text) {
+    const Tolerance &tolerance = channel.tolerance;
+    if (time < tolerance.from || time > tolerance.to) {
+        return;
+    }
+    channel.count++;
+
+    auto first = std::lower_bound(channel.expected.begin(), channel.expected.end(), time - tolerance.window, [](const Sample &sample, double t) { return sample.time < t; });
+    bool numeric = !std::isnan(value);
+    bool matched = false;
+    double bestError = std::numeric_limits<double>::infinity();
+    const Sample *closest = nullptr;
+    for (auto it = first; it != channel.expected.end() && it->time <= time + tolerance.window; it++) {
+        bool matches;
+        double error;
+        if (numeric && !std::isnan(it->value)) {
+            error = std::abs(value - it->value);
+            matches = error <= tolerance.abs + tolerance.rel * std::abs(it->value);
+        } else {
+            error = text == it->text ? 0 : std::numeric_limits<double>::infinity();
+            matches = error == 0;
+        }
+
+        if (matches) {
+            channel.matched[it - channel.expected.begin()] = true;
+            matched = true;
+        }
+        if (!closest || error < bestError) {
+            bestError = error;
+            closest = &*it;
+        }
+    }
+
+    if (closest && std::isfinite(bestError) && bestError > channel.maxError) {
+        channel.maxError = bestError;
+        channel.maxErrorTime = time;
+    }
+
+    if (!matched) {
+        channel.failures++;
+        diverge(channel, time, numeric ? fmt::format("{}", value) : std::string(text), closest ? closest->text : "nothing");
+    }
+}
+
+/**
+ * Keeps the earliest place a channel went wrong
+ */
+void LogAnalyzer::diverge(Channel &channel, double time, std::string actual, std::string expected) {
+    if (channel.diverged && channel.divergeTime <= time) {
+        return;
+    }
+    channel.diverged = true;
+    channel.divergeTime = time;
+    channel.divergeActual = actual;
+    channel.divergeExpected = expected;
+}
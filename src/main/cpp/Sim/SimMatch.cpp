@@ -0,0 +1,222 @@
+#include <frc/simulation/DriverStationSim.h>
+#include <frc/simulation/SimHooks.h>
+#include <frc/RobotController.h>
+#include <networktables/NetworkTableInstance.h>
+#include <wpi/DataLog.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "Sim/SimMatch.h"
+
+namespace {
+    const int NUM_PORTS = InputConstants::BUTTON_BOARD_PORT + 1;
+    const int NUM_AXES = 6;
+    const int NUM_BUTTONS = 32;
+    const double DISABLED_TIME = 0.1; // s before each match, for the choosers to update and the robot to settle
+    const char *CHOOSERS[] = {"First Auto Stage", "Second Auto Stage", "Third Auto Stage", "Fourth Auto Stage"};
+    const double FIELD_MARGIN = 0.5; // m past the walls the center can get, half the robot and some slack
+}
+
+/**
+ * Starts the robot on its own thread with the clock paused, everything after this moves in steps from run()
+ */
+SimMatch::SimMatch() : time_(0) {
+    frc::sim::PauseTiming();
+    frc::sim::DriverStationSim::SetDsAttached(true);
+    for (int port = 0; port < NUM_PORTS; port++) {
+        frc::sim::DriverStationSim::SetJoystickAxisCount(port, NUM_AXES);
+        frc::sim::DriverStationSim::SetJoystickButtonCount(port, NUM_BUTTONS);
+        frc::sim::DriverStationSim::SetJoystickPOVCount(port, 1);
+    }
+    clearInputs();
+
+    robot_ = std::make_unique<Robot>();
+    thread_ = std::thread([this] { robot_->StartCompetition(); });
+    frc::sim::WaitForProgramStart();
+}
+
+SimMatch::~SimMatch() {
+    robot_->EndCompetition();
+    thread_.join();
+    frc::sim::ResumeTiming();
+}
+
+/**
+ * Runs one match from disabled through auto and teleop, or until a check fails
+ */
+SimMatch::Result SimMatch::run(const Scenario &scenario) {
+    auto wallStart = std::chrono::steady_clock::now();
+    Result result{scenario.name, true, "", 0, 0, 0, {}};
+
+    reset(scenario);
+
+    std::unique_ptr<wpi::log::DataLog> log;
+    if (!scenario.logFile.empty()) {
+        log = std::make_unique<wpi::log::DataLog>("", scenario.logFile);
+        robot_->telemetry_.setLog(log.get());
+        int startEntry = log->Start("/simtesting/loginfo", "string");
+        log->AppendString(startEntry, "START", frc::RobotController::GetFPGATime());
+    }
+
+    std::vector<Input> inputs = scenario.inputs;
+    std::stable_sort(inputs.begin(), inputs.end(), [](const Input &a, const Input &b) { return a.time < b.time; });
+    size_t nextInput = 0;
+
+    frc::sim::DriverStationSim::SetAutonomous(true);
+    frc::sim::DriverStationSim::SetEnabled(true);
+    frc::sim::DriverStationSim::NotifyNewData();
+
+    double matchTime = scenario.autoTime + scenario.teleopTime;
+    bool teleop = false;
+    time_ = 0;
+    while (time_ < matchTime && result.passed) {
+        if (!teleop && time_ >= scenario.autoTime) {
+            teleop = true;
+            frc::sim::DriverStationSim::SetAutonomous(false);
+            frc::sim::DriverStationSim::NotifyNewData();
+        }
+
+        bool changed = false;
+        for (; nextInput < inputs.size() && inputs[nextInput].time <= time_; nextInput++) {
+            inputs[nextInput].apply();
+            changed = true;
+        }
+        if (changed) {
+            frc::sim::DriverStationSim::NotifyNewData();
+        }
+        frc::sim::DriverStationSim::SetMatchTime(teleop ? matchTime - time_ : scenario.autoTime - time_);
+
+        step();
+        if (time_ == 0) {
+            // AutonomousInit just put odometry at the start of the path, the model starts there too
+            getSwerveSim().reset(robot_->swerveDrive_->getX(), robot_->swerveDrive_->getY(), 0);
+        }
+        time_ += LoopConstants::SEQUENCING_PERIOD;
+
+        for (const Check &check : scenario.checks) {
+            if (time_ >= check.start && time_ <= check.end && !check.holds(*this)) {
+                result.passed = false;
+                result.failure = check.name;
+                result.failTime = time_;
+                break;
+            }
+        }
+    }
+
+    for (const Metric &metric : scenario.metrics) {
+        result.metrics.push_back(metric.measure(*this));
+    }
+
+    frc::sim::DriverStationSim::SetEnabled(false);
+    frc::sim::DriverStationSim::NotifyNewData();
+    step();
+
+    if (log) {
+        // DataLog writes out everything left and closes the file when it's destroyed, so the log is complete here
+        robot_->telemetry_.setLog(nullptr);
+        log.reset();
+    }
+
+    result.simTime = time_;
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return result;
+}
+
+/**
+ * Moves an axis from time on, it stays there until something else moves it
+ */
+SimMatch::Input SimMatch::axis(double time, int port, int axis, double value) {
+    return {time, [=] { frc::sim::DriverStationSim::SetJoystickAxis(port, axis, value); }};
+}
+
+SimMatch::Input SimMatch::button(double time, int port, int button, bool down) {
+    return {time, [=] { frc::sim::DriverStationSim::SetJoystickButton(port, button, down); }};
+}
+
+/**
+ * @param angle Degrees, -1 for not pressed
+ */
+SimMatch::Input SimMatch::pov(double time, int port, int angle) {
+    return {time, [=] { frc::sim::DriverStationSim::SetJoystickPOV(port, 0, angle); }};
+}
+
+/**
+ * The modelled robot never goes through a wall (or off to NaN), for the whole match
+ */
+SimMatch::Check SimMatch::staysOnField() {
+    return {"stays on the field", 0, std::numeric_limits<double>::infinity(), [](SimMatch &match) {
+                double x = match.getSwerveSim().getX();
+                double y = match.getSwerveSim().getY();
+                return std::isfinite(x) && std::isfinite(y) && x > -FIELD_MARGIN && x < FieldConstants::FIELD_LENGTH + FIELD_MARGIN &&
+                       y > -FIELD_MARGIN && y < FieldConstants::FIELD_WIDTH + FIELD_MARGIN;
+            }};
+}
+
+/**
+ * Seconds from the start of auto
+ */
+double SimMatch::getTime() {
+    return time_;
+}
+
+Robot &SimMatch::getRobot() {
+    return *robot_;
+}
+
+SwerveSim &SimMatch::getSwerveSim() {
+    return *robot_->swerveSim_;
+}
+
+ArmSim &SimMatch::getArmSim() {
+    return *robot_->armSim_;
+}
+
+/**
+ * One step of the sequencing task, with every control task run in it
+ */
+void SimMatch::step() {
+    frc::sim::StepTiming(units::second_t{LoopConstants::SEQUENCING_PERIOD});
+    // The telemetry thread drains on the wall clock, which would fall behind and drop samples at this speed
+    robot_->telemetry_.flush();
+}
+
+/**
+ * Disabled with nothing pressed, the scenario's autos picked, and the arm back in auto stow
+ */
+void SimMatch::reset(const Scenario &scenario) {
+    frc::sim::DriverStationSim::SetEnabled(false);
+    frc::sim::DriverStationSim::SetAutonomous(false);
+    clearInputs();
+    frc::sim::DriverStationSim::NotifyNewData();
+
+    // Same as picking them in the sim GUI, the choosers read "selected" in SmartDashboard::UpdateValues()
+    std::shared_ptr<nt::NetworkTable> dashboard = nt::NetworkTableInstance::GetDefault().GetTable("SmartDashboard");
+    for (int i = 0; i < 4; i++) {
+        if (!scenario.autos[i].empty()) {
+            dashboard->GetSubTable(CHOOSERS[i])->PutString("selected", scenario.autos[i]);
+        }
+    }
+    dashboard->GetSubTable("Auto Side")->PutString("selected", scenario.left ? "Left" : "Right");
+
+    getSwerveSim().reset(0, 0, 0);
+    getArmSim().reset(TwoJointArmConstants::ARM_POSITIONS[TwoJointArmConstants::AUTO_STOW_NUM][2], TwoJointArmConstants::ARM_POSITIONS[TwoJointArmConstants::AUTO_STOW_NUM][3]);
+    getArmSim().setCone(false);
+
+    for (double t = 0; t < DISABLED_TIME; t += LoopConstants::SEQUENCING_PERIOD) {
+        step();
+    }
+}
+
+void SimMatch::clearInputs() {
+    for (int port = 0; port < NUM_PORTS; port++) {
+        for (int axis = 0; axis < NUM_AXES; axis++) {
+            frc::sim::DriverStationSim::SetJoystickAxis(port, axis, 0);
+        }
+        for (int button = 1; button <= NUM_BUTTONS; button++) {
+            frc::sim::DriverStationSim::SetJoystickButton(port, button, false);
+        }
+        frc::sim::DriverStationSim::SetJoystickPOV(port, 0, -1);
+    }
+}
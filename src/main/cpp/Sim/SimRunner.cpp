@@ -0,0 +1,287 @@
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <fmt/format.h>
+
+#include "Sim/SimRunner.h"
+
+namespace {
+    // Tabs and newlines separate the fields and lines going back over the pipe
+    std::string clean(std::string s) {
+        std::replace(s.begin(), s.end(), '\t', ' ');
+        std::replace(s.begin(), s.end(), '\n', ' ');
+        return s;
+    }
+
+    void writeAll(int fd, const std::string &s) {
+        size_t written = 0;
+        while (written < s.size()) {
+            ssize_t n = write(fd, s.data() + written, s.size() - written);
+            if (n <= 0) {
+                return;
+            }
+            written += n;
+        }
+    }
+
+    std::string csvField(const std::string &s) {
+        std::string quoted = "\"";
+        for (char c : s) {
+            if (c == '"') {
+                quoted += '"';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+}
+
+/**
+ * @param workers How many processes to run at once, 0 for one per core
+ */
+SimRunner::SimRunner(int workers) : workers_(workers) {
+    if (workers_ <= 0) {
+        workers_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+SimRunner::Report SimRunner::run(const std::vector<SimMatch::Scenario> &scenarios) {
+    auto wallStart = std::chrono::steady_clock::now();
+    Report report{std::vector<SimMatch::Result>(scenarios.size()), 0, 0, 0};
+    std::vector<bool> done(scenarios.size(), false);
+
+    // The next scenario to start, shared by every worker
+    void *shared = mmap(nullptr, sizeof(std::atomic<int>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        std::cout << "Couldn't map the scenario counter" << std::endl;
+        return report;
+    }
+    std::atomic<int> *next = new (shared) std::atomic<int>(0);
+
+    struct Worker {
+        pid_t pid;
+        int fd;
+        std::string buffer;
+        int current; // scenario it's on, -1 between them
+    };
+    std::vector<Worker> workers;
+
+    std::cout << "Running " << scenarios.size() << " scenarios on " << workers_ << " workers" << std::endl;
+    std::fflush(stdout);
+    int numWorkers = std::min<int>(workers_, scenarios.size());
+    for (int i = 0; i < numWorkers; i++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            work(scenarios, next, fds[1]);
+            _exit(0);
+        }
+        close(fds[1]);
+        if (pid < 0) {
+            close(fds[0]);
+            break;
+        }
+        workers.push_back({pid, fds[0], "", -1});
+    }
+
+    while (!workers.empty()) {
+        std::vector<pollfd> pollFds;
+        for (Worker &worker : workers) {
+            pollFds.push_back({worker.fd, POLLIN, 0});
+        }
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+            continue;
+        }
+
+        for (int i = workers.size() - 1; i >= 0; i--) {
+            if (!(pollFds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+
+            Worker &worker = workers[i];
+            char buf[4096];
+            ssize_t n = read(worker.fd, buf, sizeof(buf));
+            if (n > 0) {
+                worker.buffer.append(buf, n);
+                size_t end;
+                while ((end = worker.buffer.find('\n')) != std::string::npos) {
+                    std::string line = worker.buffer.substr(0, end);
+                    worker.buffer.erase(0, end + 1);
+                    if (line.rfind("S\t", 0) == 0) {
+                        worker.current = std::stoi(line.substr(2));
+                    } else {
+                        size_t index;
+                        SimMatch::Result result;
+                        if (parseResult(line, scenarios, index, result)) {
+                            report.results[index] = result;
+                            done[index] = true;
+                            worker.current = -1;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            // Pipe closed, the worker finished or died
+            close(worker.fd);
+            int status = 0;
+            waitpid(worker.pid, &status, 0);
+            if (worker.current >= 0 && !done[worker.current]) {
+                std::string failure = WIFSIGNALED(status) ? fmt::format("worker crashed (signal {})", WTERMSIG(status)) : fmt::format("worker exited ({})", WEXITSTATUS(status));
+                report.results[worker.current] = {scenarios[worker.current].name, false, failure, 0, 0, 0, {}};
+                done[worker.current] = true;
+            }
+            workers.erase(workers.begin() + i);
+        }
+    }
+
+    munmap(shared, sizeof(std::atomic<int>));
+
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        if (!done[i]) {
+            report.results[i] = {scenarios[i].name, false, "not run", 0, 0, 0, {}};
+        }
+        if (report.results[i].passed) {
+            report.passed++;
+        } else {
+            report.failed++;
+            std::cout << "FAILED " << report.results[i].name << ": " << report.results[i].failure << " at " << report.results[i].failTime << " s" << std::endl;
+        }
+    }
+    report.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    std::cout << report.passed << " passed, " << report.failed << " failed in " << report.wallTime << " s" << std::endl;
+
+    return report;
+}
+
+/**
+ * Every combination of the options for the four auto stages, on both sides
+ *
+ * @param base Everything else about the scenarios, its name and log file get the combination added on
+ * @param options Option names in the choosers for each stage
+ */
+std::vector<SimMatch::Scenario> SimRunner::autoMatrix(const SimMatch::Scenario &base, const std::array<std::vector<std::string>, 4> &options) {
+    std::vector<SimMatch::Scenario> scenarios;
+    for (const std::string &a1 : options[0]) {
+        for (const std::string &a2 : options[1]) {
+            for (const std::string &a3 : options[2]) {
+                for (const std::string &a4 : options[3]) {
+                    for (bool left : {false, true}) {
+                        SimMatch::Scenario scenario = base;
+                        scenario.autos = {a1, a2, a3, a4};
+                        scenario.left = left;
+                        std::string combination = fmt::format("{} / {} / {} / {} ({})", a1, a2, a3, a4, left ? "Left" : "Right");
+                        scenario.name = base.name.empty() ? combination : base.name + ": " + combination;
+                        if (!base.logFile.empty()) {
+                            scenario.logFile = base.logFile + "-" + std::to_string(scenarios.size()) + ".wpilog";
+                        }
+                        scenarios.push_back(scenario);
+                    }
+                }
+            }
+        }
+    }
+    return scenarios;
+}
+
+/**
+ * Writes one csv row per scenario, with a column for every metric any of them had
+ *
+ * @return "" if it got written, what went wrong if not
+ */
+std::string SimRunner::writeReport(const Report &report, const std::vector<SimMatch::Scenario> &scenarios, std::string fileName) {
+    std::vector<std::string> metricNames;
+    for (const SimMatch::Scenario &scenario : scenarios) {
+        for (const SimMatch::Metric &metric : scenario.metrics) {
+            if (std::find(metricNames.begin(), metricNames.end(), metric.name) == metricNames.end()) {
+                metricNames.push_back(metric.name);
+            }
+        }
+    }
+
+    std::ofstream out(fileName);
+    if (!out.is_open()) {
+        return "could not open report file\n";
+    }
+
+    out << "name,passed,failure,fail time,sim time,wall time";
+    for (const std::string &name : metricNames) {
+        out << "," << csvField(name);
+    }
+    out << "\n";
+
+    for (size_t i = 0; i < report.results.size() && i < scenarios.size(); i++) {
+        const SimMatch::Result &result = report.results[i];
+        out << csvField(result.name) << "," << result.passed << "," << csvField(result.failure) << "," << result.failTime << "," << result.simTime << "," << result.wallTime;
+        for (const std::string &name : metricNames) {
+            out << ",";
+            for (size_t j = 0; j < scenarios[i].metrics.size() && j < result.metrics.size(); j++) {
+                if (scenarios[i].metrics[j].name == name) {
+                    out << result.metrics[j];
+                    break;
+                }
+            }
+        }
+        out << "\n";
+    }
+
+    out << "# " << report.passed << " passed, " << report.failed << " failed in " << report.wallTime << " s\n";
+    return "";
+}
+
+/**
+ * Runs in the worker, never returns to anything the parent had going
+ */
+void SimRunner::work(const std::vector<SimMatch::Scenario> &scenarios, std::atomic<int> *next, int fd) {
+    // Never destroyed, _exit() takes the robot thread down with the process
+    SimMatch *match = new SimMatch();
+
+    int i;
+    while ((i = next->fetch_add(1)) < (int)scenarios.size()) {
+        writeAll(fd, fmt::format("S\t{}\n", i));
+
+        SimMatch::Result result = match->run(scenarios[i]);
+        std::string line = fmt::format("R\t{}\t{}\t{}\t{}\t{}\t{}", i, result.passed ? 1 : 0, result.failTime, result.simTime, result.wallTime, clean(result.failure));
+        for (double metric : result.metrics) {
+            line += fmt::format("\t{}", metric);
+        }
+        writeAll(fd, line + "\n");
+    }
+
+    close(fd);
+}
+
+bool SimRunner::parseResult(const std::string &line, const std::vector<SimMatch::Scenario> &scenarios, size_t &index, SimMatch::Result &result) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, '\t')) {
+        fields.push_back(field);
+    }
+    if (fields.size() < 7 || fields[0] != "R") {
+        return false;
+    }
+
+    index = std::stoul(fields[1]);
+    if (index >= scenarios.size()) {
+        return false;
+    }
+    result = {scenarios[index].name, fields[2] == "1", fields[6], std::stod(fields[3]), std::stod(fields[4]), std::stod(fields[5]), {}};
+    for (size_t i = 7; i < fields.size(); i++) {
+        result.metrics.push_back(std::stod(fields[i]));
+    }
+    return true;
+}
@@ -0,0 +1,258 @@
+#include "Sim/SwerveSim.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <frc/RobotController.h>
+#include <frc/simulation/SimDeviceSim.h>
+
+#include "Helpers/Helpers.h"
+
+/**
+ * @param swerveDrive The drive to simulate, its modules' sim values get driven from here
+ * @param navxPort What the AHRS was made with, its sim device is named after it
+ */
+SwerveSim::SwerveSim(SwerveDrive &swerveDrive, int navxPort) : x_(0), y_(0), yaw_(0), xVel_(0), yVel_(0), omega_(0), prevTime_(-1)
+{
+    modules_[0] = ModuleSim{swerveDrive.topRight_, 1, 1};
+    modules_[1] = ModuleSim{swerveDrive.topLeft_, -1, 1};
+    modules_[2] = ModuleSim{swerveDrive.bottomRight_, 1, -1};
+    modules_[3] = ModuleSim{swerveDrive.bottomLeft_, -1, -1};
+
+    for (ModuleSim &m : modules_)
+    {
+        m.driveSign = m.module->driveMotor_.GetInverted() ? -1 : 1;
+        m.turnSign = m.module->turnMotor_.GetInverted() ? -1 : 1;
+        m.angle = m.module->getAngle();
+        m.angVel = 0;
+        m.wheelVel = 0;
+        m.drivePos = 0;
+        m.turnPos = 0;
+    }
+
+    frc::sim::SimDeviceSim navx("navX-Sensor", navxPort);
+    navxYaw_ = navx.GetDouble("Yaw");
+}
+
+/**
+ * Puts the robot somewhere, stopped
+ *
+ * @param yaw Degrees, navx convention
+ */
+void SwerveSim::reset(double x, double y, double yaw)
+{
+    x_ = x;
+    y_ = y;
+    yaw_ = yaw;
+    xVel_ = 0;
+    yVel_ = 0;
+    omega_ = 0;
+    for (ModuleSim &m : modules_)
+    {
+        m.angVel = 0;
+        m.wheelVel = 0;
+    }
+    writeSensors();
+}
+
+/**
+ * Steps by however long it's been since the last call, run it right before the control task
+ */
+void SwerveSim::update()
+{
+    double time = frc::RobotController::GetFPGATime() / 1000000.0;
+    if (prevTime_ >= 0)
+    {
+        step(time - prevTime_);
+    }
+    prevTime_ = time;
+}
+
+/**
+ * Steps the model by dt seconds, in substeps short enough for the wheel friction to stay stable
+ */
+void SwerveSim::step(double dt)
+{
+    if (dt <= 0)
+    {
+        return;
+    }
+
+    int substeps = std::ceil(dt / SwerveConstants::SIM_SUBSTEP);
+    double h = dt / substeps;
+    for (int i = 0; i < substeps; i++)
+    {
+        double forceX, forceY, torque;
+        stepModules(h, forceX, forceY, torque);
+
+        // Unrotate the force to field oriented, same as SwerveDrive::getXYVel
+        double angle = yaw_ * M_PI / 180;
+        double fieldForceX = forceX * cos(angle) - forceY * sin(angle);
+        double fieldForceY = forceX * sin(angle) + forceY * cos(angle);
+
+        xVel_ += fieldForceX / SwerveConstants::ROBOT_MASS * h;
+        yVel_ += fieldForceY / SwerveConstants::ROBOT_MASS * h;
+        omega_ += torque / SwerveConstants::ROBOT_MOI * h;
+
+        x_ += xVel_ * h;
+        y_ += yVel_ * h;
+        // turn goes the other way from yaw
+        yaw_ -= omega_ * h * 180 / M_PI;
+        Helpers::normalizeAngle(yaw_);
+    }
+
+    writeSensors();
+}
+
+/**
+ * Falcon torque at the rotor
+ *
+ * @param volts Applied voltage
+ * @param rotorSpeed rad/s
+ */
+double SwerveSim::motorTorque(double volts, double rotorSpeed)
+{
+    double current = (volts - rotorSpeed / GeneralConstants::Kv) / GeneralConstants::RESISTANCE;
+    return current / GeneralConstants::Kv;
+}
+
+/**
+ * Steps the steering of every module and works out the force and torque the wheels put on the chassis
+ *
+ * @param forceX, forceY, torque Outputs, robot oriented, torque is clockwise like omega_
+ */
+void SwerveSim::stepModules(double dt, double &forceX, double &forceY, double &torque)
+{
+    double angle = yaw_ * M_PI / 180;
+    double robotXVel = xVel_ * cos(angle) + yVel_ * sin(angle);
+    double robotYVel = yVel_ * cos(angle) + xVel_ * -sin(angle);
+
+    double corner = SwerveConstants::WHEEL_DIAGONAL / 2 / sqrt(2);
+    double normalForce = SwerveConstants::ROBOT_MASS * GeneralConstants::g / 4;
+    double ticksPerMeter = GeneralConstants::TICKS_PER_ROTATION / (2 * M_PI * SwerveConstants::TREAD_RADIUS * SwerveConstants::DRIVE_GEAR_RATIO);
+    double ticksPerDegree = GeneralConstants::TICKS_PER_ROTATION / 360.0 / SwerveConstants::SWIVEL_GEAR_RATIO;
+
+    forceX = 0;
+    forceY = 0;
+    torque = 0;
+    for (ModuleSim &m : modules_)
+    {
+        TalonFXSimCollection &driveSim = m.module->driveMotor_.GetSimCollection();
+        TalonFXSimCollection &turnSim = m.module->turnMotor_.GetSimCollection();
+        driveSim.SetBusVoltage(GeneralConstants::MAX_VOLTAGE);
+        turnSim.SetBusVoltage(GeneralConstants::MAX_VOLTAGE);
+
+        // Steering
+        double turnVolts = m.turnSign * turnSim.GetMotorOutputLeadVoltage();
+        double turnRotorSpeed = (m.angVel * M_PI / 180) / SwerveConstants::SWIVEL_GEAR_RATIO;
+        double steerTorque = motorTorque(turnVolts, turnRotorSpeed) / SwerveConstants::SWIVEL_GEAR_RATIO;
+        steerTorque -= SwerveConstants::STEER_FRICTION * m.angVel / (std::abs(m.angVel) + 1);
+        m.angVel += (steerTorque / SwerveConstants::STEER_MOI) * 180 / M_PI * dt;
+        m.angle += m.angVel * dt;
+        Helpers::normalizeAngle(m.angle);
+        m.turnPos += m.turnSign * m.angVel * dt * ticksPerDegree;
+
+        // Velocity of the floor under the wheel, along it and sideways (the wheel points at (-sin, cos), see getXYVel)
+        double moduleXVel = robotXVel + omega_ * corner * m.posY;
+        double moduleYVel = robotYVel - omega_ * corner * m.posX;
+        double wheelAngle = m.angle * M_PI / 180;
+        double alongX = -sin(wheelAngle), alongY = cos(wheelAngle);
+        double sideX = cos(wheelAngle), sideY = sin(wheelAngle);
+        m.wheelVel = moduleXVel * alongX + moduleYVel * alongY;
+        double slipVel = moduleXVel * sideX + moduleYVel * sideY;
+        m.drivePos += m.driveSign * m.wheelVel * dt * ticksPerMeter;
+
+        // Drive, limited by traction, minus rolling resistance
+        double driveVolts = m.driveSign * driveSim.GetMotorOutputLeadVoltage();
+        double driveRotorSpeed = m.wheelVel / (SwerveConstants::TREAD_RADIUS * SwerveConstants::DRIVE_GEAR_RATIO);
+        double driveForce = motorTorque(driveVolts, driveRotorSpeed) / (SwerveConstants::TREAD_RADIUS * SwerveConstants::DRIVE_GEAR_RATIO);
+        double maxForce = SwerveConstants::WHEEL_COF * normalForce;
+        driveForce = std::clamp(driveForce, -maxForce, maxForce);
+        driveForce -= SwerveConstants::ROLLING_RESISTANCE * normalForce * m.wheelVel / (std::abs(m.wheelVel) + SwerveConstants::SIM_SLIP_VEL);
+
+        // Friction against sliding sideways
+        double sideForce = -maxForce * slipVel / (std::abs(slipVel) + SwerveConstants::SIM_SLIP_VEL);
+
+        double wheelForceX = driveForce * alongX + sideForce * sideX;
+        double wheelForceY = driveForce * alongY + sideForce * sideY;
+        forceX += wheelForceX;
+        forceY += wheelForceY;
+        torque += (wheelForceX * m.posY - wheelForceY * m.posX) * corner;
+    }
+}
+
+/**
+ * Writes the state into the talons, cancoders and navx, what the drive code reads in sample()
+ */
+void SwerveSim::writeSensors()
+{
+    double ticksPerMeter = GeneralConstants::TICKS_PER_ROTATION / (2 * M_PI * SwerveConstants::TREAD_RADIUS * SwerveConstants::DRIVE_GEAR_RATIO);
+    double ticksPerDegree = GeneralConstants::TICKS_PER_ROTATION / 360.0 / SwerveConstants::SWIVEL_GEAR_RATIO;
+    const double CANCODER_TICKS = 4096;
+
+    for (ModuleSim &m : modules_)
+    {
+        // position as a change, so the turn motor keeps the position it got seeded with
+        TalonFXSimCollection &driveSim = m.module->driveMotor_.GetSimCollection();
+        driveSim.SetIntegratedSensorVelocity((int)(m.driveSign * m.wheelVel * ticksPerMeter / 10));
+        int driveTicks = (int)m.drivePos;
+        driveSim.AddIntegratedSensorPosition(driveTicks);
+        m.drivePos -= driveTicks;
+
+        TalonFXSimCollection &turnSim = m.module->turnMotor_.GetSimCollection();
+        turnSim.SetIntegratedSensorVelocity((int)(m.turnSign * m.angVel * ticksPerDegree / 10));
+        int turnTicks = (int)m.turnPos;
+        turnSim.AddIntegratedSensorPosition(turnTicks);
+        m.turnPos -= turnTicks;
+
+        // the module reads GetAbsolutePosition() + offset
+        double cancoderAngle = m.angle - m.module->offset_;
+        Helpers::normalizeAngle(cancoderAngle);
+        if (cancoderAngle < 0)
+        {
+            cancoderAngle += 360;
+        }
+        CANCoderSimCollection &cancoderSim = m.module->cancoder_.GetSimCollection();
+        cancoderSim.SetBusVoltage(GeneralConstants::MAX_VOLTAGE);
+        cancoderSim.SetRawPosition((int)(cancoderAngle / 360 * CANCODER_TICKS));
+        cancoderSim.SetVelocity((int)(m.angVel / 360 * CANCODER_TICKS / 10));
+    }
+
+    if (navxYaw_)
+    {
+        navxYaw_.Set(yaw_);
+    }
+}
+
+double SwerveSim::getX()
+{
+    return x_;
+}
+
+double SwerveSim::getY()
+{
+    return y_;
+}
+
+double SwerveSim::getYaw()
+{
+    return yaw_;
+}
+
+double SwerveSim::getXVel()
+{
+    return xVel_;
+}
+
+double SwerveSim::getYVel()
+{
+    return yVel_;
+}
+
+/**
+ * In deg/s, navx convention
+ */
+double SwerveSim::getYawVel()
+{
+    return -omega_ * 180 / M_PI;
+}
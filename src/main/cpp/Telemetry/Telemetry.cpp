@@ -0,0 +1,281 @@
+#include "Telemetry/Telemetry.h"
+
+#include <frc/DataLogManager.h>
+#include <frc/RobotController.h>
+#include <networktables/NetworkTableInstance.h>
+
+#include "Helpers/RealTime.h"
+
+Telemetry::Telemetry() : head_(0), tail_(0), dropped_(0), timestamp_(0), log_(nullptr), stopping_(false), lastPublish_(0)
+{
+}
+
+Telemetry::~Telemetry()
+{
+    stop();
+}
+
+Telemetry::Channel Telemetry::addDouble(std::string name)
+{
+    return addChannel(name, DOUBLE);
+}
+
+Telemetry::Channel Telemetry::addBoolean(std::string name)
+{
+    return addChannel(name, BOOLEAN);
+}
+
+Telemetry::Channel Telemetry::addInteger(std::string name)
+{
+    return addChannel(name, INTEGER);
+}
+
+Telemetry::Channel Telemetry::addString(std::string name)
+{
+    return addChannel(name, STRING);
+}
+
+Telemetry::Channel Telemetry::addChannel(std::string name, Type type)
+{
+    std::shared_ptr<nt::NetworkTable> table = nt::NetworkTableInstance::GetDefault().GetTable("SmartDashboard");
+
+    ChannelInfo info{name, type, -1, 0, {0}, false};
+    switch (type)
+    {
+    case DOUBLE:
+        info.publisher = doublePubs_.size();
+        doublePubs_.push_back(table->GetDoubleTopic(name).Publish());
+        break;
+    case BOOLEAN:
+        info.publisher = booleanPubs_.size();
+        booleanPubs_.push_back(table->GetBooleanTopic(name).Publish());
+        break;
+    case INTEGER:
+        info.publisher = integerPubs_.size();
+        integerPubs_.push_back(table->GetIntegerTopic(name).Publish());
+        break;
+    case STRING:
+        info.publisher = stringPubs_.size();
+        stringPubs_.push_back(table->GetStringTopic(name).Publish());
+        break;
+    }
+
+    channels_.push_back(info);
+    return channels_.size() - 1;
+}
+
+/**
+ * Sets the log to write to, defaults to the DataLogManager log (also what nullptr goes back to). If already started,
+ * everything logged so far goes to the old log first and the entries get started again in the new one.
+ */
+void Telemetry::setLog(wpi::log::DataLog *log)
+{
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    if (!thread_.joinable())
+    {
+        log_ = log;
+        return;
+    }
+
+    drain();
+    log_ = log ? log : &frc::DataLogManager::GetLog();
+    startEntries();
+}
+
+void Telemetry::start()
+{
+    if (thread_.joinable())
+    {
+        return;
+    }
+
+    if (!log_)
+    {
+        log_ = &frc::DataLogManager::GetLog();
+    }
+    startEntries();
+
+    stopping_ = false;
+    thread_ = std::thread([this]
+                          { loop(); });
+}
+
+void Telemetry::stop()
+{
+    if (!thread_.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(drainMutex_);
+        stopping_ = true;
+    }
+    stopCv_.notify_all();
+    thread_.join();
+    flush();
+}
+
+/**
+ * Drains everything logged so far right now, instead of waiting for the background thread
+ */
+void Telemetry::flush()
+{
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    drain();
+    publish();
+}
+
+/**
+ * Sets the timestamp, in us on the FPGA clock, for the samples logged after this. Call once per loop.
+ */
+void Telemetry::setTimestamp(int64_t timestamp)
+{
+    timestamp_ = timestamp;
+}
+
+void Telemetry::log(Channel channel, double value)
+{
+    Value v;
+    v.d = value;
+    push(channel, v);
+}
+
+void Telemetry::log(Channel channel, bool value)
+{
+    Value v;
+    v.b = value;
+    push(channel, v);
+}
+
+void Telemetry::log(Channel channel, int64_t value)
+{
+    Value v;
+    v.i = value;
+    push(channel, v);
+}
+
+void Telemetry::log(Channel channel, int value)
+{
+    log(channel, (int64_t)value);
+}
+
+void Telemetry::log(Channel channel, const char *value)
+{
+    Value v;
+    v.s = value;
+    push(channel, v);
+}
+
+/**
+ * Gets how many samples were thrown away because the ring was full
+ */
+uint64_t Telemetry::getNumDropped()
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void Telemetry::push(Channel channel, Value value)
+{
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= RING_SIZE)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring_[head & (RING_SIZE - 1)] = {channel, timestamp_, value};
+    head_.store(head + 1, std::memory_order_release);
+}
+
+void Telemetry::startEntries()
+{
+    static const char *typeNames[] = {"double", "boolean", "int64", "string"};
+    for (ChannelInfo &info : channels_)
+    {
+        info.logEntry = log_->Start("Telemetry/" + info.name, typeNames[info.type]);
+    }
+}
+
+// Called with drainMutex_ held
+void Telemetry::drain()
+{
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_acquire);
+    for (; tail != head; tail++)
+    {
+        const Sample &sample = ring_[tail & (RING_SIZE - 1)];
+        ChannelInfo &info = channels_[sample.channel];
+        if (info.logEntry != -1)
+        {
+            switch (info.type)
+            {
+            case DOUBLE:
+                log_->AppendDouble(info.logEntry, sample.value.d, sample.timestamp);
+                break;
+            case BOOLEAN:
+                log_->AppendBoolean(info.logEntry, sample.value.b, sample.timestamp);
+                break;
+            case INTEGER:
+                log_->AppendInteger(info.logEntry, sample.value.i, sample.timestamp);
+                break;
+            case STRING:
+                log_->AppendString(info.logEntry, sample.value.s, sample.timestamp);
+                break;
+            }
+        }
+        info.latest = sample.value;
+        info.dirty = true;
+    }
+    tail_.store(tail, std::memory_order_release);
+}
+
+// Called with drainMutex_ held, only sends the channels that changed since the last publish
+void Telemetry::publish()
+{
+    for (ChannelInfo &info : channels_)
+    {
+        if (!info.dirty)
+        {
+            continue;
+        }
+        info.dirty = false;
+
+        switch (info.type)
+        {
+        case DOUBLE:
+            doublePubs_[info.publisher].Set(info.latest.d);
+            break;
+        case BOOLEAN:
+            booleanPubs_[info.publisher].Set(info.latest.b);
+            break;
+        case INTEGER:
+            integerPubs_[info.publisher].Set(info.latest.i);
+            break;
+        case STRING:
+            stringPubs_[info.publisher].Set(info.latest.s);
+            break;
+        }
+    }
+}
+
+void Telemetry::loop()
+{
+    RealTime::makeCurrentThreadBackground(ThreadConstants::BACKGROUND_CORE);
+
+    std::unique_lock<std::mutex> lock(drainMutex_);
+    while (!stopping_)
+    {
+        stopCv_.wait_for(lock, std::chrono::milliseconds(DRAIN_PERIOD_MS), [this]
+                         { return stopping_; });
+
+        drain();
+
+        int64_t now = frc::RobotController::GetFPGATime();
+        if (now - lastPublish_ >= NT_PERIOD * 1000000)
+        {
+            publish();
+            lastPublish_ = now;
+        }
+    }
+}
@@ -1,21 +1,43 @@
+#include <algorithm>
 #include <arpa/inet.h>
+#include <cerrno>
 #include <chrono>
 #include <exception>
+#include <fcntl.h>
 #include <iostream>
+#include <poll.h>
 #include <regex>
 #include <strings.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
-#include <chrono>
+
+#include <frc/RobotController.h>
 
 #include "Vision/SocketClient.h"
+#include "Helpers/RealTime.h"
 
 #define SOCK_CLIENT_BUF_SIZE 128
+// frames are short, anything longer than this without a terminator is garbage
+#define SOCK_CLIENT_MAX_PENDING 1024
+
+// how long to wait on a non-blocking connect before giving up on the attempt
+#define SOCK_CLIENT_CONNECT_TIMEOUT_MS 250
+// reconnect backoff, doubles every failed attempt
+#define SOCK_CLIENT_MIN_BACKOFF_MS 10
+#define SOCK_CLIENT_MAX_BACKOFF_MS 500
+// ping quickly until the first clock offset is measured, then slow down to track drift
+#define SOCK_CLIENT_SYNC_PING_INTERVAL_US 100000ULL
+#define SOCK_CLIENT_PING_INTERVAL_US 1000000ULL
 
-const std::string regexp = R"(\^([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?)\$$)";
+const std::string regexp = R"(\^([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?)(?:,([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?))?\$$)";
 
+// clock sync reply from the jetson, !seq,t0,t1,t2$ (t0 is the rio send time, t1/t2 are jetson receive/send times, all in us)
+const std::string pongRegexp = R"(\!([0-9]+),([-+]?[0-9]+),([-+]?[0-9]+),([-+]?[0-9]+)\$)";
+
+// monotonic, so staleness doesn't jump when the rio sets its wall clock from the driver station
 #define GET_CUR_TIME_MS \
-  std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
 
 /**
  * Constructor
@@ -28,25 +50,60 @@ const std::string regexp = R"(\^([-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)?),([-+]?[
  * This value should be greater than staleTime.
  */
 SocketClient::SocketClient(std::string host, int port, unsigned long long staleTime, unsigned long long deadTime)
-    : m_host{host}, m_port{port}, m_staleTime{staleTime}, m_deadTime{deadTime} {}
+    : m_numClockSamples{0}, m_nextClockSample{0}, m_pingSeq{0}, m_lastPingUs{0},
+      m_host{host}, m_port{port}, m_staleTime{staleTime}, m_deadTime{deadTime}, m_stopFd{-1}, m_parseTimes{"Socket Parse", 0.005},
+      m_state{STOPPED}, m_lastTimeMs{0}, m_hasInit{false}, m_hasConn{false},
+      m_camId{0}, m_tagId{0}, m_x{0}, m_y{0}, m_angZ{0}, m_age{0}, m_count{0},
+      m_captureTime{-1}, m_clockSynced{false}, m_clockOffsetUs{0}, m_rttUs{0} {}
+
+SocketClient::~SocketClient()
+{
+  Stop();
+}
 
 /**
- * Initializes thread that fetches data from socket server
+ * Starts the thread that fetches data from socket server
  *
- * @warning Only call this once!!
+ * Does nothing if the thread is already running. Can be called again after Stop().
  */
 void SocketClient::Init()
 {
+  if (m_th.joinable())
+  {
+    return;
+  }
+
+  m_stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  m_state.store(CONNECTING);
   m_th = std::thread([this]
-                     { this->m_SocketLoop(m_host, m_port); });
-  m_th.detach();
+                     {
+                       RealTime::makeCurrentThreadBackground(ThreadConstants::BACKGROUND_CORE);
+                       this->m_SocketLoop(m_host, m_port); });
+}
+
+/**
+ * Wakes the socket thread up, closes the connection and waits for the thread to exit
+ */
+void SocketClient::Stop()
+{
+  if (!m_th.joinable())
+  {
+    return;
+  }
+
+  uint64_t one = 1;
+  write(m_stopFd, &one, sizeof(one));
+  m_th.join();
+
+  close(m_stopFd);
+  m_stopFd = -1;
 }
 
 /**
  * Returns true if connection has been established with jetson
  *
- * @note if the websocket connects then the jetson dies, then this will still return true.
- * If that is the case, use IsStale() to check the data instead.
+ * @note if the websocket connects then the jetson dies, then this will still return true until the
+ * dead time passes or the socket closes. If that is the case, use IsStale() to check the data instead.
  *
  * @returns If connection is established.
  */
@@ -55,6 +112,38 @@ bool SocketClient::HasConn()
   return m_hasConn.load();
 }
 
+/**
+ * Gets the state of the connection
+ *
+ * @returns The connection state
+ */
+SocketClient::ConnState SocketClient::GetState()
+{
+  return m_state.load();
+}
+
+/**
+ * Gets the state of the connection as a string, for the dashboard
+ *
+ * @returns The connection state
+ */
+const char *SocketClient::GetStateString()
+{
+  switch (m_state.load())
+  {
+  case STOPPED:
+    return "STOPPED";
+  case CONNECTING:
+    return "CONNECTING";
+  case CONNECTED:
+    return "CONNECTED";
+  case BACKOFF:
+    return "BACKOFF";
+  default:
+    return "UNKNOWN";
+  }
+}
+
 /**
  * Returns if age of data is too long, determined by the last time the rio has gotten data from the jetson
  *
@@ -78,7 +167,10 @@ bool SocketClient::IsStale()
 /**
  * Gets the data in vector form.
  *
- * The vector is [camId, tagId, x, y, angZ, age, uniqueId]
+ * The vector is [camId, tagId, x, y, angZ, age, uniqueId, captureTime]
+ *
+ * captureTime is when the jetson captured the frame, in seconds on the FPGA clock (same timebase as
+ * frc::Timer::GetFPGATimestamp()). It is -1 if the clocks aren't synced yet or the jetson didn't send a capture time.
  *
  * @warning Do not trust this method if IsStale() is true.
  *
@@ -93,147 +185,220 @@ std::vector<double> SocketClient::GetData()
   double z = m_angZ.load();
   double age = m_age.load();
   double uniqueId = m_count.load();
+  double captureTime = m_captureTime.load();
 
-  return std::vector<double>{camId, tagId, x, y, z, age, uniqueId};
+  return std::vector<double>{camId, tagId, x, y, z, age, uniqueId, captureTime};
 }
 
 /**
- * The loop that runs the socket
+ * Gets how long it takes to parse each batch of frames read from the socket
+ *
+ * @returns The parse time histogram
  */
-void SocketClient::m_SocketLoop(std::string host, int port)
+LatencyHistogram &SocketClient::GetParseTimes()
 {
-  int sockfd;
-  struct sockaddr_in servaddr;
+  return m_parseTimes;
+}
 
-  // socket create and verification
-  sockfd = socket(AF_INET, SOCK_STREAM, 0);
-  while (sockfd == -1)
-  {
-    // try again until good
-    sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-  }
-  bzero(&servaddr, sizeof(servaddr));
+/**
+ * Returns true once the offset between the jetson clock and the FPGA clock has been measured on the current connection
+ *
+ * @returns If the clocks are synced
+ */
+bool SocketClient::IsClockSynced()
+{
+  return m_clockSynced.load();
+}
 
-  // printf("Good socket creation\n");
+/**
+ * Gets the offset between the jetson clock and the FPGA clock (jetson - FPGA)
+ *
+ * @returns The offset in seconds
+ */
+double SocketClient::GetClockOffset()
+{
+  return m_clockOffsetUs.load() / 1000000.0;
+}
 
-  // assign IP, PORT
-  servaddr.sin_family = AF_INET;
-  servaddr.sin_addr.s_addr = inet_addr(host.c_str());
-  servaddr.sin_port = htons(port);
+/**
+ * Gets the round trip time of the clock sync sample the offset was taken from
+ *
+ * @returns The round trip time in seconds
+ */
+double SocketClient::GetRoundTripTime()
+{
+  return m_rttUs.load() / 1000000.0;
+}
 
-  // connect the client socket to server socket
-  int res = connect(sockfd, (struct sockaddr *)&servaddr, sizeof(servaddr));
-  while (res != 0)
+/**
+ * Clears the clock sync state for a new connection
+ */
+void SocketClient::m_ResetClockSync()
+{
+  m_numClockSamples = 0;
+  m_nextClockSample = 0;
+  m_lastPingUs = 0;
+  m_clockSynced.store(false);
+  m_captureTime.store(-1);
+}
+
+/**
+ * Sends a clock sync request, ?seq,t0 where t0 is the FPGA time in us
+ */
+void SocketClient::m_SendPing(int sockfd)
+{
+  unsigned long long t0 = frc::RobotController::GetFPGATime();
+  std::string ping = "?" + std::to_string(m_pingSeq++) + "," + std::to_string(t0) + "\n";
+  send(sockfd, ping.c_str(), ping.size(), MSG_NOSIGNAL);
+  m_lastPingUs = t0;
+}
+
+/**
+ * Adds a clock sync sample, and uses the sample with the lowest round trip time out of the recent ones
+ * since it has the least queueing delay mixed into the offset
+ *
+ * @param t0 FPGA time the ping was sent, in us
+ * @param t1 Jetson time the ping was received, in us
+ * @param t2 Jetson time the reply was sent, in us
+ * @param t3 FPGA time the reply was received, in us
+ */
+void SocketClient::m_HandlePong(long long t0, long long t1, long long t2, long long t3)
+{
+  long long rtt = (t3 - t0) - (t2 - t1);
+  if (rtt < 0)
   {
-    // printf("connection with the server failed ...\n");
+    return;
+  }
 
-    close(sockfd); // destroy socket
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+  m_clockSamples[m_nextClockSample] = {((t1 - t0) + (t2 - t3)) / 2, rtt};
+  m_nextClockSample = (m_nextClockSample + 1) % CLOCK_SAMPLES;
+  if (m_numClockSamples < CLOCK_SAMPLES)
+  {
+    m_numClockSamples++;
+  }
 
-    // after 1 second delay, try init socket again
-    // socket create and verification
-    sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    while (sockfd == -1)
+  ClockSample best = m_clockSamples[0];
+  for (int i = 1; i < m_numClockSamples; i++)
+  {
+    if (m_clockSamples[i].rttUs < best.rttUs)
     {
-      // try again until good
-      sockfd = socket(AF_INET, SOCK_STREAM, 0);
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      best = m_clockSamples[i];
     }
-    bzero(&servaddr, sizeof(servaddr));
+  }
 
-    // printf("Good socket creation\n");
+  m_clockOffsetUs.store(best.offsetUs);
+  m_rttUs.store(best.rttUs);
+  m_clockSynced.store(true);
+}
 
-    // assign IP, PORT
-    servaddr.sin_family = AF_INET;
-    servaddr.sin_addr.s_addr = inet_addr(host.c_str());
-    servaddr.sin_port = htons(port);
+/**
+ * Waits until the stop eventfd fires or the timeout passes
+ *
+ * @returns True if the thread should stop
+ */
+bool SocketClient::m_WaitForStop(int timeoutMs)
+{
+  struct pollfd pfd = {m_stopFd, POLLIN, 0};
+  return poll(&pfd, 1, timeoutMs) > 0;
+}
 
-    res = connect(sockfd, (struct sockaddr *)&servaddr, sizeof(servaddr));
+/**
+ * Starts a non-blocking connect and waits for it to finish, or for a stop request
+ *
+ * @returns The connected socket, or -1 if the attempt failed or the thread should stop
+ */
+int SocketClient::m_Connect(const struct sockaddr_in &servaddr)
+{
+  int sockfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (sockfd == -1)
+  {
+    return -1;
   }
 
-  m_hasConn.store(true);
-  m_camId.store(0);
-  m_tagId.store(0);
-  m_x.store(0);
-  m_y.store(0);
-  m_angZ.store(0);
-  m_age.store(0);
-  m_count.store(0);
-  m_hasInit.store(false);
-
-  while (true)
+  int res = connect(sockfd, (struct sockaddr *)&servaddr, sizeof(servaddr));
+  if (res != 0 && errno != EINPROGRESS)
   {
-    // std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    unsigned long long curTimeMs = GET_CUR_TIME_MS;
-    unsigned long long lastTimeMs = m_lastTimeMs.load();
+    close(sockfd);
+    return -1;
+  }
 
-    if (m_hasInit && curTimeMs - lastTimeMs >= m_deadTime)
+  if (res != 0)
+  {
+    struct pollfd pfds[2] = {{sockfd, POLLOUT, 0}, {m_stopFd, POLLIN, 0}};
+    if (poll(pfds, 2, SOCK_CLIENT_CONNECT_TIMEOUT_MS) <= 0 || (pfds[1].revents & POLLIN))
     {
-      // attempts to reconnect if jetson dies mid-match
-      res = -1;
-      while (res != 0)
-      {
-        // printf("connection with the server failed ...\n");
-
-        close(sockfd); // destroy socket
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-
-        // after 1 second delay, try everything
-        // socket create and verification
-        sockfd = socket(AF_INET, SOCK_STREAM, 0);
-        while (sockfd == -1)
-        {
-          // try again until good
-          sockfd = socket(AF_INET, SOCK_STREAM, 0);
-          std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-        bzero(&servaddr, sizeof(servaddr));
-
-        // printf("Good socket creation\n");
-
-        // assign IP, PORT
-        servaddr.sin_family = AF_INET;
-        servaddr.sin_addr.s_addr = inet_addr(host.c_str());
-        servaddr.sin_port = htons(port);
+      close(sockfd);
+      return -1;
+    }
 
-        res = connect(sockfd, (struct sockaddr *)&servaddr, sizeof(servaddr));
-      }
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err != 0)
+    {
+      close(sockfd);
+      return -1;
     }
+  }
 
-    char buff[SOCK_CLIENT_BUF_SIZE];
-    bzero(buff, sizeof(buff));
-    read(sockfd, buff, sizeof(buff));
-    buff[SOCK_CLIENT_BUF_SIZE - 1] = '\0';
+  return sockfd;
+}
 
-    std::regex exp(regexp);
-    std::string inp(buff);
+/**
+ * Parses every complete frame in the pending buffer and removes them from it
+ *
+ * Frames are ^data$ detections, !pong$ clock sync replies, and 0 heartbeats
+ *
+ * @param pending Bytes read but not parsed yet, anything after the last complete frame is kept
+ * @param recvTimeUs FPGA time the bytes were read, in us
+ */
+void SocketClient::m_ParseFrames(std::string &pending, long long recvTimeUs)
+{
+  ScopedTimer timer(m_parseTimes);
+  static const std::regex exp(regexp);
+  static const std::regex pongExp(pongRegexp);
 
-    // std::cout << inp << std::endl;
-    if (inp[0] == '0')
+  unsigned long long curTimeMs = GET_CUR_TIME_MS;
+  size_t pos = 0;
+  while (pos < pending.size())
+  {
+    char c = pending[pos];
+    if (c == '0')
     {
-      // store time
+      // heartbeat, store time
       m_hasInit.store(true);
       m_lastTimeMs.store(curTimeMs);
+      pos++;
+      continue;
+    }
+    if (c != '^' && c != '!')
+    {
+      // separators or garbage between frames
+      pos++;
       continue;
     }
 
-    // filter string until last dollar sign, where regex would register
-    int idx = inp.size();
-    for (int i = inp.size() - 1; i >= 0; i--)
+    size_t end = pending.find('$', pos);
+    if (end == std::string::npos)
     {
-      if (inp[i] == '$')
-      {
-        idx = i + 1;
-        break;
-      }
+      // wait for the rest of the frame
+      break;
     }
 
-    inp = inp.substr(0, idx);
+    std::string frame = pending.substr(pos, end - pos + 1);
+    pos = end + 1;
 
     std::smatch matches;
-    auto res = std::regex_match(inp, matches, exp);
-    if (res)
+    if (c == '!')
+    {
+      if (std::regex_match(frame, matches, pongExp))
+      {
+        m_HandlePong(std::stoll(matches[2]), std::stoll(matches[3]), std::stoll(matches[4]), recvTimeUs);
+      }
+      continue;
+    }
+
+    if (std::regex_match(frame, matches, exp))
     {
       // parses regex
       std::string sCamId, sTagId, sX, sY, sAngZ, sAge, sCount;
@@ -246,6 +411,16 @@ void SocketClient::m_SocketLoop(std::string host, int port)
       sAge = matches[11];
       sCount = matches[13];
 
+      // capture time is in the jetson clock, convert it to the FPGA clock
+      if (matches[15].matched && m_clockSynced.load())
+      {
+        m_captureTime.store((std::stod(matches[15]) - m_clockOffsetUs.load()) / 1000000.0);
+      }
+      else
+      {
+        m_captureTime.store(-1);
+      }
+
       // update data
       m_camId.store(std::stod(sCamId));
       m_tagId.store(std::stod(sTagId));
@@ -256,7 +431,136 @@ void SocketClient::m_SocketLoop(std::string host, int port)
       m_count.store(std::stod(sCount));
 
       // store time
+      m_hasInit.store(true);
       m_lastTimeMs.store(curTimeMs);
     }
   }
+
+  pending.erase(0, pos);
+  if (pending.size() > SOCK_CLIENT_MAX_PENDING)
+  {
+    pending.clear();
+  }
+}
+
+/**
+ * The loop that runs the socket
+ *
+ * CONNECTING -> CONNECTED when the non-blocking connect finishes, CONNECTED -> CONNECTING when the socket
+ * closes or the jetson goes quiet for the dead time, and CONNECTING -> BACKOFF -> CONNECTING on failed attempts.
+ * Every wait also polls the stop eventfd so Stop() never has to wait out a timeout.
+ */
+void SocketClient::m_SocketLoop(std::string host, int port)
+{
+  struct sockaddr_in servaddr;
+  bzero(&servaddr, sizeof(servaddr));
+
+  // assign IP, PORT
+  servaddr.sin_family = AF_INET;
+  servaddr.sin_addr.s_addr = inet_addr(host.c_str());
+  servaddr.sin_port = htons(port);
+
+  int sockfd = -1;
+  int backoffMs = SOCK_CLIENT_MIN_BACKOFF_MS;
+  std::string pending;
+  bool stop = false;
+
+  while (!stop)
+  {
+    switch (m_state.load())
+    {
+    case CONNECTING:
+    {
+      sockfd = m_Connect(servaddr);
+      if (sockfd == -1)
+      {
+        m_state.store(BACKOFF);
+        break;
+      }
+
+      backoffMs = SOCK_CLIENT_MIN_BACKOFF_MS;
+      pending.clear();
+      m_ResetClockSync();
+      m_camId.store(0);
+      m_tagId.store(0);
+      m_x.store(0);
+      m_y.store(0);
+      m_angZ.store(0);
+      m_age.store(0);
+      m_count.store(0);
+      m_hasInit.store(false);
+      m_lastTimeMs.store(GET_CUR_TIME_MS);
+      m_hasConn.store(true);
+      m_state.store(CONNECTED);
+      break;
+    }
+    case BACKOFF:
+    {
+      stop = m_WaitForStop(backoffMs);
+      backoffMs = std::min(backoffMs * 2, SOCK_CLIENT_MAX_BACKOFF_MS);
+      m_state.store(CONNECTING);
+      break;
+    }
+    case CONNECTED:
+    {
+      unsigned long long now = frc::RobotController::GetFPGATime();
+      unsigned long long pingInterval = m_clockSynced.load() ? SOCK_CLIENT_PING_INTERVAL_US : SOCK_CLIENT_SYNC_PING_INTERVAL_US;
+      if (now - m_lastPingUs >= pingInterval)
+      {
+        m_SendPing(sockfd);
+      }
+
+      // wake up for the next ping or the dead time, whichever is first
+      unsigned long long sinceDataMs = GET_CUR_TIME_MS - m_lastTimeMs.load();
+      long long untilPingMs = (long long)(m_lastPingUs + pingInterval - frc::RobotController::GetFPGATime()) / 1000;
+      long long untilDeadMs = (long long)m_deadTime - (long long)sinceDataMs;
+      int timeoutMs = (int)std::clamp(std::min(untilPingMs, untilDeadMs), 1LL, 1000LL);
+
+      struct pollfd pfds[2] = {{sockfd, POLLIN, 0}, {m_stopFd, POLLIN, 0}};
+      int ready = poll(pfds, 2, timeoutMs);
+      if (ready > 0 && (pfds[1].revents & POLLIN))
+      {
+        stop = true;
+        break;
+      }
+
+      bool closed = false;
+      if (ready > 0 && (pfds[0].revents & (POLLIN | POLLERR | POLLHUP)))
+      {
+        char buff[SOCK_CLIENT_BUF_SIZE];
+        ssize_t n;
+        while ((n = read(sockfd, buff, sizeof(buff))) > 0)
+        {
+          pending.append(buff, n);
+        }
+        // 0 means the jetson closed the socket, e.g. it rebooted
+        closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+
+        m_ParseFrames(pending, frc::RobotController::GetFPGATime());
+      }
+
+      // attempts to reconnect if jetson dies mid-match
+      if (closed || GET_CUR_TIME_MS - m_lastTimeMs.load() >= m_deadTime)
+      {
+        close(sockfd);
+        sockfd = -1;
+        m_hasConn.store(false);
+        m_clockSynced.store(false);
+        m_state.store(CONNECTING);
+      }
+      break;
+    }
+    default:
+      stop = true;
+      break;
+    }
+  }
+
+  if (sockfd != -1)
+  {
+    close(sockfd);
+  }
+  m_hasConn.store(false);
+  m_clockSynced.store(false);
+  m_state.store(STOPPED);
 }
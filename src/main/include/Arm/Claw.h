@@ -10,7 +10,7 @@
 #include <frc/Solenoid.h>
 
 #include "Helpers/TrajectoryCalc.h"
-#include "ArmConstants.h"
+#include "Arm/ArmConstants.h"
 
 class Claw
 {
@@ -10,16 +10,20 @@
 #include <frc/Timer.h>
 #include <frc/Encoder.h>
 #include <frc/DutyCycleEncoder.h>
+#include <frc/Filesystem.h>
 
 #include "Controls/Controls.h"
 #include "Helpers/Helpers.h"
+#include "Helpers/Clock.h"
 #include "Helpers/TrajectoryCalc.h"
+#include "Helpers/CANSignals.h"
+#include "Telemetry/Telemetry.h"
 #include "Sim/TalonFXSim.h"
 #include "Drivebase/SwerveConstants.h"
 
-#include "ArmConstants.h"
-#include "TwoJointArmProfiles.h"
-#include "ArmKinematics.h"
+#include "Arm/ArmConstants.h"
+#include "Arm/TwoJointArmProfiles.h"
+#include "Arm/ArmKinematics.h"
 #include "Claw.h"
 
 class TwoJointArm
@@ -35,10 +39,22 @@ class TwoJointArm
             STOPPED,
             MANUAL
         };
+
+        // Raw sensor readings, captured once per loop by sample()
+        struct Sample
+        {
+            double shoulderEncoderPos; // rotations
+            double elbowMotorPos, shoulderMotorVel, elbowMotorVel; // ticks, ticks/100ms
+            double shoulderCurrent, elbowCurrent;
+        };
+
         State getState();
         TwoJointArmProfiles::Positions getPosition();
 
+        const Sample &sample();
         void periodic();
+        void registerTelemetry(Telemetry &telemetry);
+        void logTelemetry(Telemetry &telemetry);
         void zeroArms();
         void zeroArmsToAutoStow();
         void reset();
@@ -69,9 +85,9 @@ class TwoJointArm
 
         void checkPos();
 
-        std::string getStateString();
-        std::string getPosString();
-        std::string getSetPosString();
+        const char *getStateString();
+        const char *getPosString();
+        const char *getSetPosString();
 
         // void goToPos(double thetaPos, double phiPos); //HERE
         // double getThetaVolts();
@@ -90,6 +106,8 @@ class TwoJointArm
         bool clawOpen();
 
     private:
+        friend class ArmSim;
+
         WPI_TalonFX shoulderMaster_;
         WPI_TalonFX shoulderSlave_;
         WPI_TalonFX elbowMaster_;
@@ -107,15 +125,19 @@ class TwoJointArm
         frc::Solenoid elbowBrake_;
 
         frc::DutyCycleEncoder shoulderEncoder_;
+        Sample sample_;
+        CANDeviceHealth shoulderHealth_, elbowHealth_;
+        Telemetry::Channel clawOpenChannel_;
 
         Claw claw_;
 
-        frc::Timer timer_, clawTimer_;
+        frc::Timer clawTimer_;
         //bool clawTimerStarted_;
         double taskSpaceStartTime_;
 
         TrajectoryCalc shoulderTraj_, elbowTraj_;
 
+        DirectoryStorage profileStorage_;
         TwoJointArmProfiles movementProfiles_;
         ArmKinematics armKinematics_;
 
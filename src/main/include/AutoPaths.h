@@ -5,8 +5,10 @@
 #include "GeneralConstants.h"
 #include "Drivebase/SwerveDrive.h"
 #include "Drivebase/SwervePath.h"
+#include "Helpers/Clock.h"
 #include "Arm/TwoJointArm.h"
 #include "Arm/TwoJointArmProfiles.h"
+#include "Telemetry/Telemetry.h"
 #include <vector>
 
 class AutoPaths
@@ -48,6 +50,9 @@ class AutoPaths
 
         void periodic();
         void setGyros(double yaw, double pitch, double roll);
+
+        void registerTelemetry(Telemetry &telemetry);
+        void logTelemetry(Telemetry &telemetry);
         double initYaw();
         pair<double, double> initPos();
 
@@ -81,9 +86,10 @@ class AutoPaths
         TrajectoryCalc xSlowTraj_{SwerveConstants::MAX_LV * 1.0, SwerveConstants::MAX_LA * 0.64, 0, 0, 0, 0};
         TrajectoryCalc ySlowTraj_{SwerveConstants::MAX_LV * 1.0, SwerveConstants::MAX_LA * 0.64, 0, 0, 0, 0};
 
-        frc::Timer timer_;
         frc::Timer failsafeTimer_;
-        double startTime_, curveSecondStageStartTime_, placingStartTime_, yaw_, pitch_, roll_, autoStartTime_, sendingItTime_;
+        TickClock pathClock_; // s, runs slower than real time while the drive can't keep up with the path
+        double pathStartTime_, pathClockUpdate_;
+        double startTime_, curveSecondStageStartTime_, placingStartTime_, yaw_, pitch_, roll_, autoStartTime_, sendingItTime_, dumbStartTime_;
         bool nextPointReady_, failsafeStarted_, dumbTimerStarted_, pathSet_, pathGenerated_, curveSecondStageGenerated_, yawStageGenerated_, actionsSet_, slowTraj_, mirrored_, cubeIntaking_, coneIntaking_, placingTimerStarted_, comingDownChargingStation_, taxied_, dumbAutoDocking_, sendingIt_, firstCubeArmSafety_, hitChargeStation_;
 
         //vector<SwervePath> swervePaths_;
@@ -94,8 +100,13 @@ class AutoPaths
 
         void setPath(Path path);
         Path getPath();
+        void updatePathClock(double time);
 
         bool clawOpen_, forward_;
         double wheelSpeed_;
         TwoJointArmProfiles::Positions armPosition_;
+
+        double dockTilt_;
+        bool sendingItFast_, sendingItMedium_, balanced_;
+        Telemetry::Channel actionNumChannel_, pointNumChannel_, dockTiltChannel_, hitChargeStationChannel_, sendingItFastChannel_, sendingItMediumChannel_, balancedChannel_;
 };
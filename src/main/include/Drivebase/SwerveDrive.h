@@ -7,10 +7,12 @@
 
 #include "Controls/Controls.h"
 
-#include "SwerveConstants.h"
-#include "SwervePose.h"
-#include "SwervePath.h"
+#include "Drivebase/SwerveConstants.h"
+#include "Drivebase/SwervePose.h"
+#include "Drivebase/SwervePath.h"
+#include "Drivebase/LineupPlanner.h"
 #include "SwerveModule.h"
+#include "Telemetry/Telemetry.h"
 
 #include <frc/smartdashboard/SmartDashboard.h>
 #include <frc/DriverStation.h>
@@ -20,27 +22,51 @@ class SwerveDrive
 {
     public:
         SwerveDrive();
+
+        // What calcModules keeps when the wheels can't do the whole command
+        enum DrivePriority
+        {
+            UNIFORM,
+            TRANSLATION,
+            ROTATION
+        };
+
+        struct Sample
+        {
+            SwerveModule::Sample topRight, topLeft, bottomRight, bottomLeft;
+        };
+
+        Sample sample();
         void setYaw(double yaw);
+
+        void registerTelemetry(Telemetry &telemetry);
+        void logTelemetry(Telemetry &telemetry);
         
-        void periodic(double yaw, double tilt, vector<double> data);
+        void periodic(double yaw, double tilt, vector<double> data, double time);
+        void updateOdometry(double yaw, double time);
+        void updateVision(double tilt, vector<double> data, double time);
+        void updateModules(double time);
         void teleopPeriodic(Controls* controls, bool forward, bool panic, int scoringLevel);
         void drive(double xSpeed, double ySpeed, double turn);
         void lockWheels();
         void drivePose(SwervePose pose);
         void adjustPos(SwervePose pose);
 
-        void calcModules(double xSpeed, double ySpeed, /*double xAcc, double yAcc,*/ double turn, /*double turnAacc,*/ bool inVolts);
+        void calcModules(double xSpeed, double ySpeed, double xAcc, double yAcc, double turn, double turnAcc, bool inMeters, DrivePriority priority = UNIFORM);
 
-        void calcOdometry();
+        void calcOdometry(double time);
         void reset();
 
         double getX();
         double getY();
         pair<double, double> getXYVel();
+        pair<double, double> getAchievedXYVel();
+        double getAchievedYawVel();
+        double getPathTimeScale();
         double getYaw();
         void setPos(pair<double, double> xy);
 
-        void updateAprilTagFieldXY(double tilt, vector<double> data);
+        void updateAprilTagFieldXY(double tilt, vector<double> data, double time);
         pair<double, double> checkScoringPos(int scoringLevel);
         void setScoringPos(int scoringPos);
         int getScoringPos();
@@ -49,30 +75,45 @@ class SwerveDrive
         // double getYawTagOffset();
         
     private:
-        SwerveModule* topRight_ = new SwerveModule(SwerveConstants::TR_TURN_ID, SwerveConstants::TR_DRIVE_ID, SwerveConstants::TR_CANCODER_ID, SwerveConstants::TR_CANCODER_OFFSET);
-        SwerveModule* topLeft_ = new SwerveModule(SwerveConstants::TL_TURN_ID, SwerveConstants::TL_DRIVE_ID, SwerveConstants::TL_CANCODER_ID, SwerveConstants::TL_CANCODER_OFFSET);
-        SwerveModule* bottomRight_ = new SwerveModule(SwerveConstants::BR_TURN_ID, SwerveConstants::BR_DRIVE_ID, SwerveConstants::BR_CANCODER_ID, SwerveConstants::BR_CANCODER_OFFSET);
-        SwerveModule* bottomLeft_ = new SwerveModule(SwerveConstants::BL_TURN_ID, SwerveConstants::BL_DRIVE_ID, SwerveConstants::BL_CANCODER_ID, SwerveConstants::BL_CANCODER_OFFSET);
+        friend class SwerveSim;
+
+        SwerveModule* topRight_ = new SwerveModule(SwerveConstants::TR_TURN_ID, SwerveConstants::TR_DRIVE_ID, SwerveConstants::TR_CANCODER_ID, SwerveConstants::TR_CANCODER_OFFSET, SwerveConstants::TR_DRIVE_KV_SCALE);
+        SwerveModule* topLeft_ = new SwerveModule(SwerveConstants::TL_TURN_ID, SwerveConstants::TL_DRIVE_ID, SwerveConstants::TL_CANCODER_ID, SwerveConstants::TL_CANCODER_OFFSET, SwerveConstants::TL_DRIVE_KV_SCALE);
+        SwerveModule* bottomRight_ = new SwerveModule(SwerveConstants::BR_TURN_ID, SwerveConstants::BR_DRIVE_ID, SwerveConstants::BR_CANCODER_ID, SwerveConstants::BR_CANCODER_OFFSET, SwerveConstants::BR_DRIVE_KV_SCALE);
+        SwerveModule* bottomLeft_ = new SwerveModule(SwerveConstants::BL_TURN_ID, SwerveConstants::BL_DRIVE_ID, SwerveConstants::BL_CANCODER_ID, SwerveConstants::BL_CANCODER_OFFSET, SwerveConstants::BL_DRIVE_KV_SCALE);
 
         SwervePath tagPath_{SwerveConstants::MAX_LA, SwerveConstants::MAX_LV, SwerveConstants::MAX_AA, SwerveConstants::MAX_AV};
 
         double robotX_, robotY_, yaw_/*, yawTagOffset_*/;
-        TrajectoryCalc xTagTraj_{SwerveConstants::MAX_LV * 0.7, SwerveConstants::MAX_LA * 0.7, 0, 0, 0, 0};
-        TrajectoryCalc yTagTraj_{SwerveConstants::MAX_LV * 0.7, SwerveConstants::MAX_LA * 0.7, 0, 0, 0, 0};
-        TrajectoryCalc yawTagTraj_{SwerveConstants::MAX_AV * 0.7, SwerveConstants::MAX_AA * 0.7, 0, 0, 0, 0};
+        double yawVel_; // deg/s, from the gyro
+        LineupPlanner tagLineup_{SwerveConstants::LINEUP_LV, SwerveConstants::LINEUP_LA, SwerveConstants::LINEUP_AV, SwerveConstants::LINEUP_AA};
         //double aprilTagX_, aprilTagY_;
 
         double prevTime_, dT_;
 
-        frc::Timer timer_;
         double tagFollowingStartTime_;
 
         double trSpeed_, brSpeed_, tlSpeed_, blSpeed_, trAngle_, brAngle_, tlAngle_, blAngle_, holdingYaw_;
+        double translationScale_ = 1, turnScale_ = 1;
+        double achievedXVel_ = 0, achievedYVel_ = 0, achievedYawVel_ = 0;
+        double pathTimeScale_ = 1;
+        double trAcc_ = 0, brAcc_ = 0, tlAcc_ = 0, blAcc_ = 0, trAngVel_ = 0, brAngVel_ = 0, tlAngVel_ = 0, blAngVel_ = 0;
+
+        double maxModuleSpeed(double x, double y, double turn);
+        void desaturate(double x, double y, double turn, DrivePriority priority, double &translationScale, double &turnScale);
+        void calcModule(double x, double y, double xAcc, double yAcc, double turn, double turnAcc, int posX, int posY, bool moving,
+                        double &speed, double &angle, double &acc, double &angVel);
 
         bool trackingTag_, trackingPlayerStation_, foundTag_, isHoldingYaw_/*, inching_*/;
         int setTagPos_, prevTag_, prevUniqueVal_, numLargeDiffs_;
         double xLineupTrim_, yLineupTrim_;
 
+        // Dashboard values, kept here and logged from logTelemetry() so the control loop never touches NetworkTables
+        double tagWantedX_, tagWantedY_, tagWantedYaw_, tagFieldX_, tagFieldY_;
+        bool differentTag_;
+        Telemetry::Channel xTrimChannel_, yTrimChannel_, tagWantedXChannel_, tagWantedYChannel_, tagFieldXChannel_, tagFieldYChannel_, differentTagChannel_;
+        Telemetry::Channel translationScaleChannel_, turnScaleChannel_, pathTimeScaleChannel_;
+
         map<double, pair<pair<double, double>, pair<double, double>>> prevPoses_;
 
 };
\ No newline at end of file
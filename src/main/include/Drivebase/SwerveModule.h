@@ -9,8 +9,10 @@
 #include "Controls/Controls.h"
 #include "Helpers/Helpers.h"
 #include "Helpers/TrajectoryCalc.h"
+#include "Helpers/CANSignals.h"
+#include "Telemetry/Telemetry.h"
 
-#include "SwerveConstants.h"
+#include "Drivebase/SwerveConstants.h"
 
 //#include <frc/MotorSafety.h>
 //#include <frc/smartdashboard/SmartDashboard.h>
@@ -19,25 +21,47 @@
 class SwerveModule
 {
     public:
-        SwerveModule(int turnID, int driveID, int cancoderID, double offset);
+        SwerveModule(int turnID, int driveID, int cancoderID, double offset, double kVScale);
 
-        void periodic(double driveSpeed, double angle, bool inVolts);
-        void move(double driveSpeed, double angle, bool inVolts);
+        // Sensor readings, captured once per loop by sample()
+        struct Sample
+        {
+            double angle; // degrees, robot oriented
+            double driveVelocity; // m/s
+        };
 
+        const Sample &sample();
+        void periodic(double velocity, double angle, double acceleration = 0, double angularVelocity = 0);
+        void update(double time);
+        void move(double velocity, double angle, double acceleration);
+        void moveOnboard(double velocity, double angle, double acceleration);
+
+        double optimize(double angle);
         double calcAngPID(double setAngle);
-        double calcDrivePID(double driveSpeed);
+        double calcSteerFeedForward();
+        double calcDriveFeedForward(double velocity, double acceleration);
+        double calcDrivePID(double velocity, double acceleration);
         double findError(double setAngle, double angle);
         
         double getDriveVelocity();
         double getAngle();
 
+        void registerTelemetry(Telemetry &telemetry);
+        void logTelemetry(Telemetry &telemetry);
+
         void setP(double p){ akP_ = p; }
         void setD(double d){ akD_ = d; }
 
     private:
+        friend class SwerveSim;
+
         WPI_TalonFX turnMotor_;
         WPI_TalonFX driveMotor_;
         WPI_CANCoder cancoder_;
+        Sample sample_{};
+        double continuousAngle_ = 0; // unwrapped cancoder angle, what the turn motor's encoder gets seeded with
+        double steerAngle_ = 0; // continuous angle the steering is going to, rate limited
+        CANDeviceHealth driveHealth_, cancoderHealth_;
 
         double maxV = 1440;
         double maxA = 14400 * 10;
@@ -52,19 +76,19 @@ class SwerveModule
         
         std::string id_;
         double offset_;
-        int direction_ = 1;
+        double kVScale_;
+
+        double setVelocity_ = 0, setAngle_ = 0, setAcceleration_ = 0, setAngularVelocity_ = 0;
+        double extrapolatedTime_ = 0; // s setAngle_ has been moved along since the last setpoint
+
+        void configureOnboard();
 
         double prevTime_, dT_;
-        frc::Timer timer_;
 
-        double aPrevError_, aIntegralError_, dPrevError_, dIntegralError_;
+        double aPrevError_, aIntegralError_;
 
         double akP_ = 0.1; //COULDO tune values 0.08, 0, 0.001 (0.1, 0, 0.001)
         double akI_ = 0.0;
         double akD_ = 0.001;
 
-        double dkP_ = 0.0;
-        double dkI_ = 0.0;
-        double dkD_ = 0.0;
-
 };
\ No newline at end of file
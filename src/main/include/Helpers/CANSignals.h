@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <ctre/Phoenix.h>
+
+#include "GeneralConstants.h"
+#include "Telemetry/Telemetry.h"
+
+// Phoenix getters never block, they return the last status frame the device broadcast. So every device sends the
+// frames the loop reads once per run of the task that reads them, everything else gets slowed down, and each subsystem
+// reads its devices once in sample().
+namespace CANSignals
+{
+    void configureFeedbackMotor(WPI_TalonFX &motor, int feedbackPeriod);
+    void configureOutputMotor(WPI_TalonFX &motor);
+    void configureFollowerMotor(WPI_TalonFX &motor);
+    void configureCANCoder(WPI_CANCoder &cancoder);
+    void setControlPeriod(WPI_TalonFX &motor, int period);
+}
+
+// Tracks whether the frames read from one device are actually fresh, updated from sample()
+class CANDeviceHealth
+{
+public:
+    CANDeviceHealth(std::string name);
+
+    void update(ctre::phoenix::ErrorCode error);
+    void update(ctre::phoenix::ErrorCode error, double frameTime);
+
+    uint64_t getErrors();
+    uint64_t getRepeats();
+    double getFrameGap();
+
+    void registerTelemetry(Telemetry &telemetry);
+    void logTelemetry(Telemetry &telemetry);
+
+private:
+    std::string name_;
+
+    uint64_t errors_;  // reads that came back with an error, usually a missed frame
+    uint64_t repeats_; // reads that got the same frame as the loop before
+    double lastFrameTime_, frameGap_; // s, frameGap_ is the longest time between new frames since the last log
+
+    Telemetry::Channel errorChannel_, repeatChannel_, gapChannel_;
+};
+
+// Utilization and error counters for a whole bus, the rio bus or a CANivore. Reading the CANivore status goes through
+// its daemon and can take a while, so it's polled on a background thread and the loop only logs the latest values.
+class CANBusMonitor
+{
+public:
+    CANBusMonitor(std::string bus);
+    ~CANBusMonitor();
+
+    void start();
+    void stop();
+
+    void registerTelemetry(Telemetry &telemetry);
+    void logTelemetry(Telemetry &telemetry);
+
+private:
+    void update();
+    void loop();
+
+    std::string bus_;
+
+    std::atomic<double> utilization_;
+    std::atomic<int64_t> busOffCount_, txFullCount_, receiveErrors_, transmitErrors_;
+    std::atomic<bool> ok_;
+
+    std::thread thread_;
+    std::mutex stopMutex_;
+    std::condition_variable stopCv_;
+    bool stopping_;
+
+    Telemetry::Channel utilizationChannel_, busOffChannel_, txFullChannel_, receiveErrorChannel_, transmitErrorChannel_;
+};
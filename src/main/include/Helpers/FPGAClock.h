@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Helpers/Clock.h"
+
+// The FPGA timestamp, where the robot's TickClock gets set from. In sim it's the sim clock, so stepped timing moves it
+// too.
+class FPGAClock : public Clock
+{
+    public:
+        double getTime() override;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "Telemetry/Telemetry.h"
+
+// Fixed bucket latency histogram, cheap enough to record into every loop. Recording is lock free so
+// other threads (like the socket thread) can time themselves and the robot loop can still read the results.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram(std::string name, double deadline);
+
+    void record(int64_t us);
+    void reset();
+
+    double getPercentile(double percentile);
+    double getMax();
+    uint64_t getCount();
+    uint64_t getOverruns();
+    std::string getSummary();
+
+    void registerTelemetry(Telemetry &telemetry);
+    void logTelemetry(Telemetry &telemetry);
+
+private:
+    static constexpr int BUCKET_WIDTH = 50; // us
+    static constexpr int NUM_BUCKETS = 200; // last one is everything over 10 ms
+
+    std::string name_;
+    int64_t deadline_; // us
+
+    std::atomic<uint32_t> buckets_[NUM_BUCKETS];
+    std::atomic<uint64_t> count_, overruns_;
+    std::atomic<int64_t> max_;
+
+    Telemetry::Channel p50Channel_, p99Channel_, maxChannel_, overrunChannel_;
+};
+
+// Records how long it lives into a histogram
+class ScopedTimer
+{
+public:
+    ScopedTimer(LatencyHistogram &histogram) : histogram_(histogram), start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        histogram_.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count());
+    }
+
+private:
+    LatencyHistogram &histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "GeneralConstants.h"
+
+// Thread priority and core pinning. The robot loop thread runs every control loop, so it gets SCHED_FIFO on its own core,
+// and the threads that only move data off the robot (telemetry, vision socket) stay at normal priority on the other core.
+namespace RealTime
+{
+    bool makeCurrentThreadRealTime(int priority, int core);
+    bool makeCurrentThreadBackground(int core);
+    bool pinCurrentThread(int core);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <frc/TimedRobot.h>
+
+#include "Helpers/LoopTimer.h"
+#include "Telemetry/Telemetry.h"
+
+// Runs tasks at their own rates through TimedRobot::AddPeriodic, so they all share the (real time) robot loop thread and
+// never run at the same time. Each task is timed, and a deadline miss is a task finishing after its next release.
+class TaskScheduler
+{
+public:
+    TaskScheduler(frc::TimedRobot &robot);
+
+    void addTask(std::string name, std::function<void()> task, double period, double offset);
+    void reset();
+
+    uint64_t getCount(std::string name);
+    uint64_t getMisses(std::string name);
+    std::vector<std::string> getSummaries();
+
+    void registerTelemetry(Telemetry &telemetry);
+    void logTelemetry(Telemetry &telemetry);
+
+private:
+    struct Task
+    {
+        std::string name;
+        std::function<void()> task;
+        int64_t period;  // us
+        int64_t release; // us, when it was supposed to start, -1 until the first run
+        uint64_t misses;
+        LatencyHistogram times;
+        Telemetry::Channel missChannel;
+    };
+
+    void run(Task &task);
+    Task *find(std::string name);
+
+    frc::TimedRobot &robot_;
+    std::vector<std::unique_ptr<Task>> tasks_; // pointers so the callbacks can hold on to them
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <units/angle.h>
+
+// The parts of Helpers that need WPILib's units, the rest is in the core library
+namespace Helpers
+{
+    units::radian_t convertStepsToRadians(double val, double numStepsPerRevolution);
+}
@@ -21,6 +21,7 @@
 #include <units/time.h>
 
 #include "Helpers/Helpers.h"
+#include "Helpers/Units.h"
 #include "IntakeConstants.h"
 
 /**
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -28,11 +29,21 @@
 #include "Intake/PneumaticsIntake.h"
 #include "Intake/CubeGrabber.h"
 #include "Vision/SocketClient.h"
+#include "Telemetry/Telemetry.h"
+#include "Helpers/LoopTimer.h"
+#include "Helpers/TaskScheduler.h"
+#include "Helpers/CANSignals.h"
+#include "Helpers/RealTime.h"
+#include "Helpers/FPGAClock.h"
+#include "RobotSnapshot.h"
+#include "Sim/SwerveSim.h"
+#include "Sim/ArmSim.h"
 
 class Robot : public frc::TimedRobot
 {
 public:
     Robot();
+    ~Robot() override;
     void RobotInit() override;
     void RobotPeriodic() override;
     void AutonomousInit() override;
@@ -45,6 +56,8 @@ public:
     void TestPeriodic() override;
 
 private:
+    friend class SimMatch;
+
     frc::SendableChooser<AutoPaths::Path> auto1Chooser_;
     frc::SendableChooser<AutoPaths::Path> auto2Chooser_;
     frc::SendableChooser<AutoPaths::Path> auto3Chooser_;
@@ -61,9 +74,35 @@ private:
     PneumaticsIntake cubeIntake_{false, false};
     CubeGrabber cubeGrabber_;
     SocketClient socketClient_;
+    std::unique_ptr<SwerveSim> swerveSim_; // only in simulation
+    std::unique_ptr<ArmSim> armSim_;       // only in simulation
+
+    Telemetry telemetry_;
+    Telemetry::Channel yawChannel_, navxAliveChannel_, dataStaleChannel_, cameraConnChannel_, cameraStateChannel_, tiltChannel_, pitchChannel_, rollChannel_;
+    Telemetry::Channel forwardChannel_, posKnownChannel_, intakingCubeChannel_, eStoppedChannel_, armsZeroedChannel_, armStateChannel_, armPosChannel_, armSetPosChannel_;
+    Telemetry::Channel xChannel_, yChannel_, thetaChannel_, phiChannel_, scoringPosChannel_, cutoutIntakingChannel_, cutoutOutakingChannel_, cubeIntakeDownChannel_;
+
+    TaskScheduler scheduler_{*this};
+    LatencyHistogram swerveTimes_{"Swerve", LoopConstants::CONTROL_PERIOD};
+    LatencyHistogram armTimes_{"Arm", LoopConstants::CONTROL_PERIOD};
+    LatencyHistogram visionTimes_{"Vision", LoopConstants::SEQUENCING_PERIOD};
+    LatencyHistogram intakeTimes_{"Intake", LoopConstants::SEQUENCING_PERIOD};
+    LatencyHistogram autoTimes_{"Auto", LoopConstants::SEQUENCING_PERIOD};
+    LatencyHistogram teleopDriveTimes_{"Teleop Drive", LoopConstants::SEQUENCING_PERIOD};
+    void logTimes();
+    void dumpTimes();
+
+    CANBusMonitor rioBus_{CANConstants::RIO_BUS};
+    CANBusMonitor drivebaseBus_{CANConstants::DRIVEBASE_BUS};
+    void logSubsystems();
 
     double yawOffset_;
 
+    RobotSnapshot snapshot_;
+    FPGAClock fpgaClock_;
+    TickClock tickClock_; // snapshot_.time, the default clock while the robot is up
+    void sample();
+
     frc::Timer timer_;
     double coneGrabTimerStartTime_;
     bool coneGrabTimerStarted_;
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+#include "Arm/TwoJointArm.h"
+#include "Drivebase/SwerveDrive.h"
+
+// Every sensor input for one tick of the 5 ms loop, captured once at the top of the loop by Robot::sample()
+struct RobotSnapshot
+{
+    double time;
+
+    // navx, yaw has the field orient offset, pitch and roll have their offsets
+    bool navxConnected;
+    double yaw, pitch, roll, tilt;
+    double rawPitch, rawRoll;
+
+    // jetson, see SocketClient::GetData()
+    std::vector<double> visionData;
+    bool visionStale, visionConnected;
+    const char *visionState;
+
+    TwoJointArm::Sample arm;
+    SwerveDrive::Sample swerve;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ctre/Phoenix.h>
+#include <hal/SimDevice.h>
+
+#include "Arm/TwoJointArm.h"
+
+// Physics model of the arm for desktop simulation. The upper arm and forearm (plus a cone in the claw if there is one)
+// are a coupled two link pendulum, driven by two Falcons per joint through the real gearing. The elbow motors sit on the
+// base, so moving the shoulder also turns the elbow unless the elbow motor turns with it, same as getPhi(). Each brake
+// locks its gearbox while the solenoid is off, and the joints stop dead a bit past the soft limits.
+//
+// step() doesn't look at the clock, so a test can run it as fast as it wants.
+class ArmSim
+{
+public:
+    ArmSim(TwoJointArm &arm);
+
+    void reset(double theta, double phi);
+    void update();
+    void step(double dt);
+
+    void setCone(bool hasCone);
+
+    double getTheta();
+    double getPhi();
+    double getThetaVel();
+    double getPhiVel();
+    bool shoulderBraked();
+    bool elbowBraked();
+
+private:
+    static double motorTorque(double volts, double rotorSpeed);
+    static double motorCurrent(double volts, double rotorSpeed);
+    void substep(double dt);
+    void writeSensors();
+
+    TwoJointArm &arm_;
+    hal::SimDouble encoderPos_;
+
+    double shoulderSign_, elbowSign_; // rotor direction of positive theta and phi, the sim values don't go through SetInverted
+    double theta_, phi_;              // rad, forward convention, theta from straight up and phi relative to the upper arm
+    double thetaVel_, phiVel_;        // rad/s
+    double shoulderCurrent_, elbowCurrent_; // A, supply, per motor
+    double shoulderPos_, elbowPos_;   // rotor ticks not yet sent
+    bool hasCone_;
+    double prevTime_;
+};
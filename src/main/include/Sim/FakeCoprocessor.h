@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Stand-in for the jetson's socket server, speaks the same protocol SocketClient expects
+// ^camId,tagId,x,y,angZ,age,uniqueId,captureTime$ detections, 0 heartbeats, and ?seq,t0 / !seq,t0,t1,t2$ clock sync
+class FakeCoprocessor
+{
+public:
+    struct Detection
+    {
+        int camId;
+        int tagId;
+        double x, y, angZ;
+    };
+
+    struct Config
+    {
+        double rate = 30;            // frames per second
+        double latency = 0.04;       // capture to send, seconds
+        double jitter = 0.01;        // latency is uniformly +- this, seconds
+        double dropChance = 0;       // chance a frame starts a drop
+        int dropBurst = 1;           // frames dropped in a row once a drop starts
+        double clockOffset = 12.5;   // jetson clock - rio clock, seconds
+        bool sendCaptureTime = true; // false acts like an old jetson that only sends age
+        unsigned int seed = 114;
+    };
+
+    struct SentFrame
+    {
+        unsigned long long uniqueId;
+        uint64_t captureTime; // rio clock, us
+        uint64_t sendTime;    // rio clock, us
+    };
+
+    // returns false if there's nothing in view at that time
+    using DetectionSource = std::function<bool(double time, Detection &detection)>;
+
+    FakeCoprocessor(int port, Config config);
+    ~FakeCoprocessor();
+
+    void setSource(DetectionSource source);
+    bool loadRecording(std::string filePath, bool loop);
+    void setClock(std::function<uint64_t()> clockUs);
+
+    void start();
+    void stop();
+
+    bool hasClient();
+    int getNumSent();
+    int getNumDropped();
+    std::vector<SentFrame> getSentFrames();
+
+private:
+    struct PendingFrame
+    {
+        Detection detection;
+        uint64_t captureTime;
+        uint64_t sendTime;
+    };
+
+    void loop();
+    void handlePings(int clientFd, std::string &pending);
+    void queueFrame(uint64_t now);
+    void sendDueFrames(int clientFd, uint64_t now);
+
+    int port_;
+    Config config_;
+    DetectionSource source_;
+    std::function<uint64_t()> clockUs_;
+
+    std::thread thread_;
+    int stopFd_;
+    std::atomic<bool> hasClient_;
+
+    std::mt19937 rng_;
+    uint64_t startTime_, nextCaptureTime_, lastSendTime_;
+    int dropsLeft_;
+    unsigned long long count_;
+    std::vector<PendingFrame> pendingFrames_;
+
+    std::mutex statsMutex_;
+    std::vector<SentFrame> sentFrames_;
+    int numDropped_;
+};
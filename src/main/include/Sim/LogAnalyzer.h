@@ -0,0 +1,81 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Compares a wpilog against an expected trace in one pass over the records. The expected file is the watched entry
+// names on the first line, then "time,name,value" lines; it gets indexed by name up front. Watched entry IDs are
+// resolved as their start records go by, so every other record is skipped after one hash lookup, and nothing gets
+// formatted unless printing or the debug csv is on.
+//
+// A sample matches if an expected sample of the same channel within the channel's window of it is within
+// abs + rel * |expected| (text has to be the same), and every expected sample has to get matched by something. Lines
+// starting with # set the tolerances, for every channel or for one, and can limit a channel to part of the match:
+//     #default,abs=0.01,rel=0.001,window=0.02
+//     #channel,Telemetry/Theta,abs=0.5,from=2,to=14.5
+class LogAnalyzer {
+public:
+    static constexpr double DEFAULT_VALUE_TOLERANCE = 1e-6;
+    static constexpr double DEFAULT_TIME_TOLERANCE = 0.011; // s, a sequencing tick plus the rounding in the expected file
+
+    LogAnalyzer();
+
+    std::string loadExpected(std::string fileName);
+    std::string analyze(std::string logFileName);
+    std::string getReport();
+
+    void setPrint(bool print);
+    void setDebugFile(std::string fileName);
+    void setTolerance(double value, double time);
+
+private:
+    enum Type {DOUBLE, INTEGER, BOOLEAN, STRING, OTHER};
+
+    struct Tolerance {
+        double abs, rel;
+        double window; // s either way to look for the expected sample
+        double from, to; // s, only compared in here
+    };
+
+    struct Sample {
+        double time;
+        double value; // NaN if it isn't a number
+        std::string text;
+    };
+
+    struct Channel {
+        Tolerance tolerance;
+        bool customTolerance;
+        std::vector<Sample> expected; // by time
+        std::vector<bool> matched;
+
+        size_t count, failures;
+        double maxError, maxErrorTime;
+        bool diverged;
+        double divergeTime;
+        std::string divergeActual, divergeExpected;
+    };
+
+    struct Entry {
+        std::string name;
+        std::string type;
+        Type kind;
+        Channel *channel; // nullptr if not watched
+    };
+
+    static Type kindOf(std::string_view type);
+    static double parseNumber(std::string_view text);
+    static bool parseTolerance(const std::vector<std::string> &fields, size_t first, Tolerance &tolerance);
+    void compare(Channel &channel, double time, double value, std::string_view text);
+    static void diverge(Channel &channel, double time, std::string actual, std::string expected);
+
+    std::unordered_map<std::string, Channel> channels_;
+    std::vector<std::string> names_; // watched, in the order of the expected file's header
+    Tolerance default_;
+    bool print_;
+    std::string debugFileName_;
+    std::ofstream debugFile_;
+};
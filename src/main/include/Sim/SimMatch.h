@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Robot.h"
+
+// Runs whole matches (auto then teleop) against the robot in simulated time, as fast as the code runs. Driver inputs are
+// scripted, checks get evaluated every step while the match runs, and a match can keep its own log, which is complete
+// on disk by the time run() returns.
+//
+// The robot owns the HAL devices, so there's one SimMatch per process and every scenario runs on it in turn.
+class SimMatch {
+public:
+    // Something the driver does, time is from the start of auto
+    struct Input {
+        double time;
+        std::function<void()> apply;
+    };
+
+    // Has to hold at every step from start to end
+    struct Check {
+        std::string name;
+        double start, end;
+        std::function<bool(SimMatch &)> holds;
+    };
+
+    // Read once at the end of the match, like a score or the final pose error
+    struct Metric {
+        std::string name;
+        std::function<double(SimMatch &)> measure;
+    };
+
+    struct Scenario {
+        std::string name;
+        std::array<std::string, 4> autos; // option names in the auto stage choosers, empty keeps what was picked last
+        bool left = false;
+        double autoTime = 15;
+        double teleopTime = 135;
+        std::vector<Input> inputs;
+        std::vector<Check> checks;
+        std::vector<Metric> metrics;
+        std::string logFile; // empty for no log
+    };
+
+    struct Result {
+        std::string name;
+        bool passed;
+        std::string failure; // the first check that didn't hold
+        double failTime;
+        double simTime, wallTime;
+        std::vector<double> metrics; // in the same order as the scenario's
+    };
+
+    SimMatch();
+    ~SimMatch();
+
+    Result run(const Scenario &scenario);
+
+    static Input axis(double time, int port, int axis, double value);
+    static Input button(double time, int port, int button, bool down);
+    static Input pov(double time, int port, int angle);
+    static Check staysOnField();
+
+    double getTime();
+    Robot &getRobot();
+    SwerveSim &getSwerveSim();
+    ArmSim &getArmSim();
+
+private:
+    void step();
+    void reset(const Scenario &scenario);
+    void clearInputs();
+
+    std::unique_ptr<Robot> robot_;
+    std::thread thread_;
+    double time_;
+};
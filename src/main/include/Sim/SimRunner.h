@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Sim/SimMatch.h"
+
+// Runs scenarios across every core. Each worker is a forked process with its own HAL and its own SimMatch, and takes
+// the next scenario nobody has started yet until they're all done, so a slow scenario doesn't hold up the rest. Results
+// come back over a pipe; a worker that crashes fails the scenario it was on and the others carry on.
+//
+// Run it before anything in this process starts a robot or threads, only the calling thread makes it into the workers.
+class SimRunner {
+public:
+    struct Report {
+        std::vector<SimMatch::Result> results; // in scenario order
+        int passed, failed;
+        double wallTime;
+    };
+
+    SimRunner(int workers = 0);
+
+    Report run(const std::vector<SimMatch::Scenario> &scenarios);
+
+    static std::vector<SimMatch::Scenario> autoMatrix(const SimMatch::Scenario &base, const std::array<std::vector<std::string>, 4> &options);
+    static std::string writeReport(const Report &report, const std::vector<SimMatch::Scenario> &scenarios, std::string fileName);
+
+private:
+    static void work(const std::vector<SimMatch::Scenario> &scenarios, std::atomic<int> *next, int fd);
+    static bool parseResult(const std::string &line, const std::vector<SimMatch::Scenario> &scenarios, size_t &index, SimMatch::Result &result);
+
+    int workers_;
+};
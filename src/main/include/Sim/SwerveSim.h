@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+
+#include <ctre/Phoenix.h>
+#include <hal/SimDevice.h>
+
+#include "Drivebase/SwerveDrive.h"
+#include "Drivebase/SwerveModule.h"
+
+// Physics model of the drivebase for desktop simulation. Reads the voltage each talon is putting out, steps the motors,
+// modules and chassis, and writes the results back into the talon, cancoder and navx sim values, so the normal drive
+// code runs against it unchanged. Drive wheels push along the way they're pointed up to the traction limit, and
+// sideways slip is fought by friction.
+class SwerveSim
+{
+public:
+    SwerveSim(SwerveDrive &swerveDrive, int navxPort);
+
+    void reset(double x, double y, double yaw);
+    void update();
+    void step(double dt);
+
+    double getX();
+    double getY();
+    double getYaw();
+    double getXVel();
+    double getYVel();
+    double getYawVel();
+
+private:
+    struct ModuleSim
+    {
+        SwerveModule *module;
+        int posX, posY; // which corner, 1 or -1, same as SwerveDrive::calcModules
+        double driveSign, turnSign; // rotor direction of forward, the sim values don't go through SetInverted
+        double angle, angVel; // degrees and deg/s
+        double wheelVel; // m/s
+        double drivePos, turnPos; // rotor ticks not yet sent
+    };
+
+    static double motorTorque(double volts, double rotorSpeed);
+    void stepModules(double dt, double &forceX, double &forceY, double &torque);
+    void writeSensors();
+
+    std::array<ModuleSim, 4> modules_;
+    hal::SimDouble navxYaw_;
+
+    double x_, y_, yaw_;         // field, m and degrees (navx convention)
+    double xVel_, yVel_, omega_; // field m/s, and rad/s clockwise like the turn in calcModules
+    double prevTime_;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <networktables/BooleanTopic.h>
+#include <networktables/DoubleTopic.h>
+#include <networktables/IntegerTopic.h>
+#include <networktables/StringTopic.h>
+#include <wpi/DataLog.h>
+
+// Typed telemetry channels. The control loop writes fixed size samples into a lock free ring and a background
+// thread drains them to the DataLog (every sample) and to NetworkTables under SmartDashboard/ (latest value, throttled)
+//
+// Register every channel before start(). Only one thread (the robot loop) can log, the ring is single producer.
+class Telemetry
+{
+public:
+    using Channel = uint16_t;
+
+    Telemetry();
+    ~Telemetry();
+
+    Channel addDouble(std::string name);
+    Channel addBoolean(std::string name);
+    Channel addInteger(std::string name);
+    Channel addString(std::string name);
+
+    void setLog(wpi::log::DataLog *log);
+    void start();
+    void stop();
+    void flush();
+
+    void setTimestamp(int64_t timestamp);
+    void log(Channel channel, double value);
+    void log(Channel channel, bool value);
+    void log(Channel channel, int64_t value);
+    void log(Channel channel, int value);
+    void log(Channel channel, const char *value); // value has to be a string literal or otherwise live forever
+
+    uint64_t getNumDropped();
+
+private:
+    enum Type
+    {
+        DOUBLE,
+        BOOLEAN,
+        INTEGER,
+        STRING
+    };
+
+    union Value
+    {
+        double d;
+        int64_t i;
+        bool b;
+        const char *s;
+    };
+
+    struct Sample
+    {
+        Channel channel;
+        int64_t timestamp;
+        Value value;
+    };
+
+    struct ChannelInfo
+    {
+        std::string name;
+        Type type;
+        int logEntry;
+        int publisher; // index into the publisher vector for its type
+        Value latest;
+        bool dirty;
+    };
+
+    Channel addChannel(std::string name, Type type);
+    void push(Channel channel, Value value);
+    void startEntries();
+    void drain();
+    void publish();
+    void loop();
+
+    static constexpr size_t RING_SIZE = 4096; // power of 2
+    static constexpr double NT_PERIOD = 0.05;
+    static constexpr int DRAIN_PERIOD_MS = 10;
+
+    Sample ring_[RING_SIZE];
+    std::atomic<size_t> head_, tail_;
+    std::atomic<uint64_t> dropped_;
+    int64_t timestamp_;
+
+    std::vector<ChannelInfo> channels_;
+    std::vector<nt::DoublePublisher> doublePubs_;
+    std::vector<nt::BooleanPublisher> booleanPubs_;
+    std::vector<nt::IntegerPublisher> integerPubs_;
+    std::vector<nt::StringPublisher> stringPubs_;
+
+    wpi::log::DataLog *log_;
+    std::thread thread_;
+    std::mutex drainMutex_;
+    std::condition_variable stopCv_;
+    bool stopping_;
+    int64_t lastPublish_;
+};
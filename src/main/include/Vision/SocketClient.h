@@ -5,21 +5,64 @@
 #include <thread>
 #include <vector>
 
+#include <netinet/in.h>
+
+#include "Helpers/LoopTimer.h"
+
 class SocketClient
 {
 public:
+  enum ConnState
+  {
+    STOPPED,
+    CONNECTING,
+    CONNECTED,
+    BACKOFF
+  };
+
   SocketClient(std::string host, int port, unsigned long long staleTime, unsigned long long deadTime);
+  ~SocketClient();
 
   void Init();
+  void Stop();
 
   bool HasConn();
   bool IsStale();
+  ConnState GetState();
+  const char *GetStateString();
+  LatencyHistogram &GetParseTimes();
 
   std::vector<double> GetData();
 
+  bool IsClockSynced();
+  double GetClockOffset();
+  double GetRoundTripTime();
+
 private:
+  friend class SocketClientBench;
+
   void m_SocketLoop(std::string host, int port);
 
+  int m_Connect(const struct sockaddr_in &servaddr);
+  bool m_WaitForStop(int timeoutMs);
+  void m_ParseFrames(std::string &pending, long long recvTimeUs);
+
+  void m_ResetClockSync();
+  void m_SendPing(int sockfd);
+  void m_HandlePong(long long t0, long long t1, long long t2, long long t3);
+
+  struct ClockSample
+  {
+    long long offsetUs;
+    long long rttUs;
+  };
+  static constexpr int CLOCK_SAMPLES = 8;
+  ClockSample m_clockSamples[CLOCK_SAMPLES];
+  int m_numClockSamples;
+  int m_nextClockSample;
+  unsigned long long m_pingSeq;
+  unsigned long long m_lastPingUs;
+
   std::thread m_th;
 
   std::string m_host;
@@ -27,6 +70,10 @@ private:
   unsigned long long m_staleTime;
   unsigned long long m_deadTime;
 
+  int m_stopFd;
+  LatencyHistogram m_parseTimes;
+  std::atomic<ConnState> m_state;
+
   std::atomic<unsigned long long> m_lastTimeMs;
 
   std::atomic<bool> m_hasInit;
@@ -39,4 +86,9 @@ private:
   std::atomic<double> m_angZ;
   std::atomic<long long> m_age;
   std::atomic<unsigned long long> m_count;
+  std::atomic<double> m_captureTime;
+
+  std::atomic<bool> m_clockSynced;
+  std::atomic<long long> m_clockOffsetUs;
+  std::atomic<long long> m_rttUs;
 };
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <functional>
+#include <map>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "Sim/FakeCoprocessor.h"
+#include "Vision/SocketClient.h"
+
+namespace
+{
+    const int PORT = 15808; // not the real jetson port, so a running sim doesn't grab it
+    const double CAPTURE_TOLERANCE = 0.001; // s, clock sync over loopback is much better than this
+
+    FakeCoprocessor::Config lossyConfig()
+    {
+        FakeCoprocessor::Config config;
+        config.rate = 50;
+        config.latency = 0.03;
+        config.jitter = 0.01;
+        config.dropChance = 0.1;
+        config.dropBurst = 3;
+        return config;
+    }
+
+    bool waitFor(std::function<bool()> condition, double timeout)
+    {
+        auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > end)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+// Everything the client reports a capture time for should line up with when the server actually captured it
+TEST(FakeCoprocessorTest, CaptureTimeMatchesServer)
+{
+    FakeCoprocessor coprocessor(PORT, lossyConfig());
+    coprocessor.setSource([](double time, FakeCoprocessor::Detection &detection)
+                          {
+                              detection = {0, 3, 1.5, 2.0, 180};
+                              return true;
+                          });
+    coprocessor.start();
+
+    SocketClient client("127.0.0.1", PORT, 500, 5000);
+    client.Init();
+    ASSERT_TRUE(waitFor([&] { return client.IsClockSynced(); }, 3));
+
+    // uniqueId -> capture time in s, read twice so a frame landing mid-read doesn't mix two of them
+    std::map<unsigned long long, double> received;
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        std::vector<double> data = client.GetData();
+        std::vector<double> again = client.GetData();
+        if (data[6] == again[6] && data[7] == again[7] && data[6] > 0 && data[7] >= 0)
+        {
+            received[(unsigned long long)data[6]] = data[7];
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    client.Stop();
+    coprocessor.stop();
+
+    std::map<unsigned long long, double> sent;
+    for (const FakeCoprocessor::SentFrame &frame : coprocessor.getSentFrames())
+    {
+        sent[frame.uniqueId] = frame.captureTime / 1000000.0;
+    }
+
+    ASSERT_GT(received.size(), 20u);
+    for (const auto &[uniqueId, captureTime] : received)
+    {
+        ASSERT_EQ(sent.count(uniqueId), 1u) << "client got frame " << uniqueId << " that was never sent";
+        EXPECT_NEAR(captureTime, sent[uniqueId], CAPTURE_TOLERANCE) << "frame " << uniqueId;
+    }
+}
+
+// Drops come in whole bursts, jitter stays in its window, and frames never pass each other
+TEST(FakeCoprocessorTest, DropsAndJitter)
+{
+    FakeCoprocessor::Config config = lossyConfig();
+    FakeCoprocessor coprocessor(PORT, config);
+    coprocessor.setSource([](double time, FakeCoprocessor::Detection &detection)
+                          {
+                              detection = {1, 7, 0.5, -0.5, 90};
+                              return true;
+                          });
+    coprocessor.start();
+
+    SocketClient client("127.0.0.1", PORT, 500, 5000);
+    client.Init();
+    ASSERT_TRUE(waitFor([&] { return coprocessor.getNumSent() >= 100; }, 5));
+    client.Stop();
+    coprocessor.stop();
+
+    std::vector<FakeCoprocessor::SentFrame> frames = coprocessor.getSentFrames();
+    EXPECT_GT(coprocessor.getNumDropped(), 0);
+
+    uint64_t period = 1000000 / config.rate;
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        double latency = (frames[i].sendTime - frames[i].captureTime) / 1000000.0;
+        EXPECT_GE(latency, config.latency - config.jitter - 1e-6);
+        EXPECT_LE(latency, config.latency + config.jitter + 1e-6);
+        EXPECT_EQ(frames[i].uniqueId, i + 1);
+
+        if (i > 0)
+        {
+            EXPECT_GE(frames[i].sendTime, frames[i - 1].sendTime);
+
+            uint64_t gap = frames[i].captureTime - frames[i - 1].captureTime;
+            ASSERT_EQ(gap % period, 0u);
+            EXPECT_EQ((gap / period - 1) % config.dropBurst, 0u) << "frame " << frames[i].uniqueId;
+        }
+    }
+}
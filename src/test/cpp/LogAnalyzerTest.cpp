@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <wpi/DataLog.h>
+
+#include "gtest/gtest.h"
+
+#include "Sim/LogAnalyzer.h"
+
+namespace
+{
+    const int64_t START_TIME = 5000000; // us, when the log's START marker is, sample times are from it
+    const double TICK = 0.01; // s, one sequencing run
+
+    struct Record
+    {
+        std::string name;
+        double time, value;
+    };
+
+    std::string tempPath(const std::string &name)
+    {
+        return (std::filesystem::temp_directory_path() / ("LogAnalyzerTest-" + name)).string();
+    }
+
+    // A wpilog like SimMatch writes, double channels started as they first show up. DataLog writes everything out and
+    // closes the file when it's destroyed, so it's complete when this returns.
+    std::string writeLog(const std::string &name, const std::vector<Record> &records)
+    {
+        std::filesystem::path path = tempPath(name + ".wpilog");
+        std::filesystem::remove(path);
+        {
+            wpi::log::DataLog log{path.parent_path().string(), path.filename().string()};
+            int startEntry = log.Start("/simtesting/loginfo", "string");
+            log.AppendString(startEntry, "START", START_TIME);
+
+            std::vector<std::pair<std::string, int>> entries;
+            for (const Record &record : records)
+            {
+                auto entry = std::find_if(entries.begin(), entries.end(), [&](const auto &e) { return e.first == record.name; });
+                if (entry == entries.end())
+                {
+                    entries.push_back({record.name, log.Start(record.name, "double")});
+                    entry = entries.end() - 1;
+                }
+                log.AppendDouble(entry->second, record.value, START_TIME + std::llround(record.time * 1000000));
+            }
+        }
+        return path.string();
+    }
+
+    std::string writeExpected(const std::string &name, const std::string &contents)
+    {
+        std::string path = tempPath(name + ".csv");
+        std::ofstream(path) << contents;
+        return path;
+    }
+
+    // A sample every 0.1 s from 0 to 1 s of value(time) on name, shifted in time by shift
+    std::vector<Record> trace(const std::string &name, double (*value)(double), double shift = 0)
+    {
+        std::vector<Record> records;
+        for (int i = 0; i <= 10; i++)
+        {
+            double time = i * 0.1;
+            records.push_back({name, time + shift, value(time)});
+        }
+        return records;
+    }
+
+    std::string expectedLines(const std::vector<Record> &records)
+    {
+        std::string lines;
+        for (const Record &record : records)
+        {
+            lines += std::to_string(record.time) + "," + record.name + "," + std::to_string(record.value) + "\n";
+        }
+        return lines;
+    }
+
+    double ramp(double time)
+    {
+        return 100 + 2 * time;
+    }
+
+    std::string analyze(const std::string &name, const std::string &expected, const std::vector<Record> &actual)
+    {
+        LogAnalyzer analyzer;
+        std::string loaded = analyzer.loadExpected(writeExpected(name, expected));
+        if (!loaded.empty())
+        {
+            return "load: " + loaded;
+        }
+        return analyzer.analyze(writeLog(name, actual));
+    }
+}
+
+TEST(LogAnalyzerTest, MatchesWithinTolerance)
+{
+    std::string expected = "Telemetry/X,Telemetry/Y\n"
+                           "#default,abs=0.01\n"
+                           "#channel,Telemetry/Y,abs=0,rel=0.001\n" +
+                           expectedLines(trace("Telemetry/X", ramp)) + expectedLines(trace("Telemetry/Y", ramp));
+
+    // 0.009 off on X is inside abs, 0.09 off on Y (about 0.09% of 100) is inside rel
+    std::vector<Record> actual;
+    for (Record record : trace("Telemetry/X", ramp))
+    {
+        record.value += 0.009;
+        actual.push_back(record);
+    }
+    for (Record record : trace("Telemetry/Y", ramp))
+    {
+        record.value += 0.09;
+        actual.push_back(record);
+    }
+    EXPECT_EQ(analyze("within", expected, actual), "");
+}
+
+// The robot landing a sample one sequencing run later than the expected trace has it still matches
+TEST(LogAnalyzerTest, AllowsOneTickOfJitter)
+{
+    std::string expected = "Telemetry/X\n" + expectedLines(trace("Telemetry/X", ramp));
+    EXPECT_EQ(analyze("late", expected, trace("Telemetry/X", ramp, TICK)), "");
+    EXPECT_EQ(analyze("early", expected, trace("Telemetry/X", ramp, -TICK)), "");
+}
+
+TEST(LogAnalyzerTest, RejectsJustOutsideTolerance)
+{
+    std::string expected = "Telemetry/X\n#default,abs=0.01\n" + expectedLines(trace("Telemetry/X", ramp));
+
+    std::vector<Record> off = trace("Telemetry/X", ramp);
+    off[4].value += 0.0101;
+    EXPECT_NE(analyze("value", expected, off), "");
+
+    std::vector<Record> late = trace("Telemetry/X", ramp);
+    late[4].time += 0.012;
+    EXPECT_NE(analyze("time", expected, late), "");
+}
+
+TEST(LogAnalyzerTest, ReportsFirstDivergenceAndMaxError)
+{
+    auto one = [](double time) { return 1.0; };
+    std::string expected = "Telemetry/X,Telemetry/Y\n#default,abs=0.01\n" + expectedLines(trace("Telemetry/X", one)) + expectedLines(trace("Telemetry/Y", one));
+
+    std::vector<Record> actual = trace("Telemetry/X", one);
+    actual[3].value = 1.5;
+    actual[6].value = 1.75;
+    std::vector<Record> y = trace("Telemetry/Y", one);
+    actual.insert(actual.end(), y.begin(), y.end());
+
+    // Both wrong samples miss, and so do the expected ones they were supposed to match
+    EXPECT_EQ(analyze("report", expected, actual), "Telemetry/X: 4 off of 11 samples, first at 0.30 s (1.5, expected 1.000000), max error 0.75 at 0.60 s\n"
+                                                   "Telemetry/Y: ok, 11 samples, max error 0 at 0.00 s\n");
+}
+
+TEST(LogAnalyzerTest, OnlyComparesInsideFromTo)
+{
+    std::string expected = "Telemetry/X\n#channel,Telemetry/X,abs=0.01,from=0.25,to=0.55\n" + expectedLines(trace("Telemetry/X", ramp));
+
+    // Way off everywhere outside the window, and nothing at all for the expected samples past it
+    std::vector<Record> actual;
+    for (Record record : trace("Telemetry/X", ramp))
+    {
+        if (record.time > 0.55)
+        {
+            break;
+        }
+        if (record.time < 0.25)
+        {
+            record.value = -1;
+        }
+        actual.push_back(record);
+    }
+    EXPECT_EQ(analyze("window", expected, actual), "");
+
+    actual[3].value += 1;
+    EXPECT_NE(analyze("window-off", expected, actual), "");
+}
+
+// Every expected sample has to be matched, a log that stops early fails where it stopped
+TEST(LogAnalyzerTest, MissingSamplesFail)
+{
+    std::string expected = "Telemetry/X\n" + expectedLines(trace("Telemetry/X", ramp));
+    std::vector<Record> actual = trace("Telemetry/X", ramp);
+    actual.resize(8);
+
+    std::string report = analyze("missing", expected, actual);
+    EXPECT_NE(report.find("Telemetry/X: 3 off of 8 samples, first at 0.80 s (nothing, expected 101.600000)"), std::string::npos) << report;
+}
+
+TEST(LogAnalyzerTest, BadToleranceDoesNotLoad)
+{
+    LogAnalyzer analyzer;
+    EXPECT_NE(analyzer.loadExpected(writeExpected("bad-key", "Telemetry/X\n#default,slack=0.1\n")), "");
+    EXPECT_NE(analyzer.loadExpected(writeExpected("bad-value", "Telemetry/X\n#default,abs=lots\n")), "");
+    EXPECT_NE(analyzer.loadExpected(writeExpected("bad-channel", "Telemetry/X\n#channel,Telemetry/Z,abs=0.1\n")), "");
+}
@@ -0,0 +1,73 @@
+#include <cmath>
+#include <iostream>
+
+#include "gtest/gtest.h"
+
+#include "Controls/InputConstants.h"
+#include "Sim/SimMatch.h"
+#include "Sim/SimRunner.h"
+
+namespace
+{
+    const double AUTO_TIME = 15;
+    const double STICK_DOWN = AUTO_TIME + 0.5, STICK_UP = AUTO_TIME + 2.5;
+    const double MIN_REAL_TIME_FACTOR = 50;
+
+    double speed(SimMatch &match)
+    {
+        return std::hypot(match.getSwerveSim().getXVel(), match.getSwerveSim().getYVel());
+    }
+}
+
+// A short scripted match: drive back in auto, then the driver pushes the left stick forward for 2 s and lets go.
+// Runs in a SimRunner worker so this process never starts a robot, the auto matrix test forks from it too.
+TEST(SimMatchTest, ScriptedTeleopDrive)
+{
+    SimMatch::Scenario scenario;
+    scenario.name = "drive back, then teleop forward";
+    scenario.autos = {"Drive Back Dumb", "Nothing", "Nothing", "Nothing"};
+    scenario.autoTime = AUTO_TIME;
+    scenario.teleopTime = 5;
+    scenario.inputs = {SimMatch::axis(STICK_DOWN, InputConstants::LJOY_PORT, InputConstants::LJOY_Y, -0.6),
+                       SimMatch::axis(STICK_UP, InputConstants::LJOY_PORT, InputConstants::LJOY_Y, 0)};
+    scenario.checks = {SimMatch::staysOnField(),
+                       {"drives with the stick held", STICK_DOWN + 1, STICK_UP, [](SimMatch &match) { return speed(match) > 0.5; }},
+                       {"stops after letting go", STICK_UP + 1.5, AUTO_TIME + 5, [](SimMatch &match) { return speed(match) < 0.1; }}};
+    scenario.metrics = {{"final x", [](SimMatch &match) { return match.getSwerveSim().getX(); }},
+                        {"final y", [](SimMatch &match) { return match.getSwerveSim().getY(); }}};
+
+    SimRunner::Report report = SimRunner(1).run({scenario});
+    ASSERT_EQ(report.results.size(), 1u);
+
+    const SimMatch::Result &result = report.results[0];
+    EXPECT_TRUE(result.passed) << result.failure << " at " << result.failTime << " s";
+    EXPECT_NEAR(result.simTime, AUTO_TIME + 5, 0.05);
+    ASSERT_EQ(result.metrics.size(), 2u);
+    EXPECT_TRUE(std::isfinite(result.metrics[0]) && std::isfinite(result.metrics[1]));
+
+    // Only recorded, wall time on a loaded machine is no reason to fail, DISABLED_FullMatchSpeed holds it to a number
+    double realTimeFactor = result.simTime / result.wallTime;
+    std::cout << "Ran " << result.simTime << " s of match in " << result.wallTime << " s, " << realTimeFactor << "x real time" << std::endl;
+    RecordProperty("realTimeFactor", std::to_string(realTimeFactor));
+}
+
+// A whole 150 s match has to run at least 50x real time. Opt-in with the other long sim tests, ./gradlew check
+// -PlongSimTests, on a machine that isn't busy with anything else.
+TEST(SimMatchTest, DISABLED_FullMatchSpeed)
+{
+    SimMatch::Scenario scenario;
+    scenario.name = "full match";
+    scenario.autos = {"Preloaded Cone High", "First Cube High", "Second Cube Dock", "Nothing"};
+    scenario.inputs = {SimMatch::axis(STICK_DOWN, InputConstants::LJOY_PORT, InputConstants::LJOY_Y, -0.6),
+                       SimMatch::axis(STICK_UP, InputConstants::LJOY_PORT, InputConstants::LJOY_Y, 0)};
+
+    SimRunner::Report report = SimRunner(1).run({scenario});
+    ASSERT_EQ(report.results.size(), 1u);
+
+    const SimMatch::Result &result = report.results[0];
+    EXPECT_NEAR(result.simTime, scenario.autoTime + scenario.teleopTime, 0.05);
+
+    double realTimeFactor = result.simTime / result.wallTime;
+    RecordProperty("realTimeFactor", std::to_string(realTimeFactor));
+    EXPECT_GE(realTimeFactor, MIN_REAL_TIME_FACTOR) << "ran " << result.simTime << " s of match in " << result.wallTime << " s";
+}
@@ -0,0 +1,86 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Sim/SimMatch.h"
+#include "Sim/SimRunner.h"
+
+namespace
+{
+    // The options in each auto stage chooser, same names as Robot::Robot() gives them
+    const std::array<std::vector<std::string>, 4> AUTO_OPTIONS{{
+        {"Preloaded Cone Mid", "Preloaded Cone High", "Preloaded Cone High Middle", "Preloaded Cone Mid Middle", "Nothing", "Drive Back Dumb", "Wait Five Seconds", "Taxi Dock Dumb"},
+        {"First Cube High", "Second Cube Dock", "Nothing", "Drive Back Dumb", "Wait Five Seconds", "Taxi Dock Dumb"},
+        {"First Cube High", "Second Cube Mid", "Second Cube Dock", "Second Cube Grab", "Nothing", "Drive Back Dumb", "Wait Five Seconds", "Taxi Dock Dumb"},
+        {"Second Cube Mid", "Second Cube Dock", "Second Cube Grab", "Nothing", "Drive Back Dumb", "Wait Five Seconds", "Taxi Dock Dumb"}}};
+
+    // A few that drive, score and dock, for every build
+    const std::array<std::vector<std::string>, 4> SMOKE_OPTIONS{{
+        {"Preloaded Cone High", "Taxi Dock Dumb"},
+        {"First Cube High", "Nothing"},
+        {"Second Cube Dock"},
+        {"Nothing"}}};
+
+    // Runs every scenario auto only across every core, all of them have to stay on the field
+    void runAutoMatrix(const std::array<std::vector<std::string>, 4> &options, size_t count, std::string reportFile)
+    {
+        SimMatch::Scenario base;
+        base.teleopTime = 0;
+        base.checks = {SimMatch::staysOnField()};
+        base.metrics = {{"final x", [](SimMatch &match) { return match.getSwerveSim().getX(); }},
+                        {"final y", [](SimMatch &match) { return match.getSwerveSim().getY(); }}};
+
+        std::vector<SimMatch::Scenario> scenarios = SimRunner::autoMatrix(base, options);
+        ASSERT_EQ(scenarios.size(), count);
+
+        SimRunner::Report report = SimRunner().run(scenarios);
+        EXPECT_EQ(SimRunner::writeReport(report, scenarios, reportFile), "");
+
+        ASSERT_EQ(report.results.size(), scenarios.size());
+        for (const SimMatch::Result &result : report.results)
+        {
+            EXPECT_TRUE(result.passed) << result.name << ": " << result.failure << " at " << result.failTime << " s";
+        }
+        EXPECT_EQ(report.failed, 0);
+        EXPECT_EQ(report.passed, (int)scenarios.size());
+    }
+}
+
+TEST(SimRunnerTest, AutoMatrixSmoke)
+{
+    runAutoMatrix(SMOKE_OPTIONS, 2u * 2 * 1 * 1 * 2, "sim-auto-smoke.csv");
+}
+
+// Every combination of the four stages on both sides, 5376 autos (22 hours of match), so it's left out of the default
+// run. ./gradlew check -PlongSimTests runs it.
+TEST(SimRunnerTest, DISABLED_FullAutoMatrix)
+{
+    runAutoMatrix(AUTO_OPTIONS, 8u * 6 * 8 * 7 * 2, "sim-auto-matrix.csv");
+}
+
+// A check that never holds has to come back over the pipe as that scenario failing, without taking the others with it
+TEST(SimRunnerTest, ReportsFailedChecks)
+{
+    SimMatch::Scenario passing;
+    passing.name = "passing";
+    passing.autos = {"Nothing", "Nothing", "Nothing", "Nothing"};
+    passing.autoTime = 0.5;
+    passing.teleopTime = 0;
+
+    SimMatch::Scenario failing = passing;
+    failing.name = "failing";
+    failing.checks = {{"never holds", 0.2, 0.5, [](SimMatch &match) { return false; }}};
+
+    SimRunner::Report report = SimRunner(2).run({passing, failing, passing});
+    ASSERT_EQ(report.results.size(), 3u);
+    EXPECT_TRUE(report.results[0].passed);
+    EXPECT_FALSE(report.results[1].passed);
+    EXPECT_EQ(report.results[1].name, "failing");
+    EXPECT_EQ(report.results[1].failure, "never holds");
+    EXPECT_NEAR(report.results[1].failTime, 0.2, 0.011);
+    EXPECT_TRUE(report.results[2].passed);
+    EXPECT_EQ(report.passed, 2);
+    EXPECT_EQ(report.failed, 1);
+}
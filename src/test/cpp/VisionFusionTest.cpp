@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <frc/Timer.h>
+
+#include "gtest/gtest.h"
+
+#include "Drivebase/SwerveDrive.h"
+#include "GeneralConstants.h"
+#include "Sim/FakeCoprocessor.h"
+#include "Vision/SocketClient.h"
+
+namespace
+{
+    const int PORT = 15809; // not the real jetson port or FakeCoprocessorTest's
+    const int TAG_ID = 2;
+    const double ODOMETRY_DRIFT = 0.2; // m/s the wheels think the robot moved in x that it didn't, like slipping on carpet
+    const double SETTLE_TIME = 1; // s, before the pose error counts
+
+    // Where the robot really is at time (s, FPGA clock), sweeping side to side in front of the tag at up to pi m/s
+    struct Truth
+    {
+        double start;
+
+        double x(double time)
+        {
+            return 13.5;
+        }
+
+        double y(double time)
+        {
+            return FieldConstants::TAG_XY[TAG_ID - 1][1] + std::sin(M_PI * (time - start));
+        }
+    };
+
+    // Tag relative position SwerveDrive::updateAprilTagFieldXY turns back into the robot's field position, facing the
+    // tag square so angZ is 0
+    FakeCoprocessor::Detection detectionAt(double x, double y)
+    {
+        return {0, TAG_ID, y - FieldConstants::TAG_XY[TAG_ID - 1][1], FieldConstants::TAG_XY[TAG_ID - 1][0] - x, 0};
+    }
+
+    struct FusionResult
+    {
+        int fused = 0;
+        double maxError = 0, rmsError = 0; // m, after SETTLE_TIME
+        double maxLatency = 0, meanLatency = 0; // s, capture to the tick the pose took it in
+    };
+
+    // Runs the drive's odometry at the control rate and fuses vision at the sequencing rate for duration seconds, in
+    // real time since the client and server are on the FPGA clock. The odometry follows the truth plus drift, and
+    // disturb can knock it around at a given time.
+    FusionResult runFusion(FakeCoprocessor::Config config, double duration, std::function<void(SwerveDrive &, double)> disturb = nullptr)
+    {
+        FusionResult result;
+
+        Truth truth{frc::Timer::GetFPGATimestamp().value()};
+        FakeCoprocessor coprocessor(PORT, config);
+        coprocessor.setSource([&](double time, FakeCoprocessor::Detection &detection)
+                              {
+                                  detection = detectionAt(truth.x(time), truth.y(time));
+                                  return true;
+                              });
+        coprocessor.start();
+
+        SocketClient client("127.0.0.1", PORT, 500, 5000);
+        client.Init();
+        auto syncEnd = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (!client.IsClockSynced() && std::chrono::steady_clock::now() < syncEnd)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_TRUE(client.IsClockSynced());
+
+        SwerveDrive drive;
+        double start = frc::Timer::GetFPGATimestamp().value();
+        double prevTime = start;
+        double lastUniqueId = -1, sumSquaredError = 0, sumLatency = 0;
+        int numErrors = 0;
+        int controlPerSequencing = std::lround(LoopConstants::SEQUENCING_PERIOD / LoopConstants::CONTROL_PERIOD);
+
+        auto tick = std::chrono::steady_clock::now();
+        for (int i = 0; i * LoopConstants::CONTROL_PERIOD < duration; i++)
+        {
+            tick += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(LoopConstants::CONTROL_PERIOD));
+            std::this_thread::sleep_until(tick);
+            double time = frc::Timer::GetFPGATimestamp().value();
+
+            drive.setPos({drive.getX() + truth.x(time) - truth.x(prevTime) + ODOMETRY_DRIFT * (time - prevTime), drive.getY() + truth.y(time) - truth.y(prevTime)});
+            prevTime = time;
+            if (disturb)
+            {
+                disturb(drive, time - start);
+            }
+            drive.updateOdometry(0, time);
+
+            if (i % controlPerSequencing != 0)
+            {
+                continue;
+            }
+
+            // Read twice so a frame landing mid-read doesn't mix two of them
+            std::vector<double> data = client.GetData();
+            std::vector<double> again = client.GetData();
+            if (data != again)
+            {
+                continue;
+            }
+            drive.updateVision(0, data, time);
+
+            if (data[0] != -1 && data[6] != lastUniqueId && data[7] > 0)
+            {
+                lastUniqueId = data[6];
+                double latency = time - data[7];
+                result.fused++;
+                result.maxLatency = std::max(result.maxLatency, latency);
+                sumLatency += latency;
+            }
+
+            if (time - start > SETTLE_TIME)
+            {
+                double error = std::hypot(drive.getX() - truth.x(time), drive.getY() - truth.y(time));
+                result.maxError = std::max(result.maxError, error);
+                sumSquaredError += error * error;
+                numErrors++;
+            }
+        }
+
+        client.Stop();
+        coprocessor.stop();
+
+        result.rmsError = numErrors > 0 ? std::sqrt(sumSquaredError / numErrors) : 0;
+        result.meanLatency = result.fused > 0 ? sumLatency / result.fused : 0;
+        std::cout << "Fused " << result.fused << " frames, pose error rms " << result.rmsError << " m max " << result.maxError
+                  << " m, latency mean " << result.meanLatency << " s max " << result.maxLatency << " s" << std::endl;
+        return result;
+    }
+}
+
+// A lossy camera at 50 fps watching the robot sweep past the tag has to keep the fused pose on the robot even with the
+// odometry drifting away, which only works if each frame is compared against where the odometry was when it was captured
+TEST(VisionFusionTest, PoseErrorAndLatency)
+{
+    FakeCoprocessor::Config config;
+    config.rate = 50;
+    config.latency = 0.03;
+    config.jitter = 0.01;
+    config.dropChance = 0.05;
+    config.dropBurst = 3;
+
+    FusionResult result = runFusion(config, 4);
+    RecordProperty("rmsError", std::to_string(result.rmsError));
+    RecordProperty("maxError", std::to_string(result.maxError));
+    RecordProperty("meanLatency", std::to_string(result.meanLatency));
+    RecordProperty("maxLatency", std::to_string(result.maxLatency));
+
+    ASSERT_GT(result.fused, 100);
+    // Comparing against the current pose instead would be off by up to pi m/s * 40 ms = 0.13 m
+    EXPECT_LT(result.rmsError, 0.03);
+    EXPECT_LT(result.maxError, 0.06);
+    // Capture to fused is the camera's latency plus at most one sequencing run waiting for the next read
+    EXPECT_GE(result.meanLatency, config.latency - config.jitter);
+    EXPECT_LT(result.maxLatency, config.latency + config.jitter + LoopConstants::SEQUENCING_PERIOD + 0.01);
+}
+
+// Knocking the odometry half a meter off (a wheel lifting over the charge station) gets pulled back within a few frames
+TEST(VisionFusionTest, RecoversFromOdometryJump)
+{
+    FakeCoprocessor::Config config;
+    config.rate = 50;
+    config.latency = 0.03;
+    config.jitter = 0.01;
+
+    bool jumped = false;
+    FusionResult result = runFusion(config, 2, [&](SwerveDrive &drive, double time)
+                                    {
+                                        if (!jumped && time > 0.5)
+                                        {
+                                            drive.setPos({drive.getX() + 0.5, drive.getY()});
+                                            jumped = true;
+                                        }
+                                    });
+    // By SETTLE_TIME it's had 25 frames to pull the pose back
+    ASSERT_TRUE(jumped);
+    ASSERT_GT(result.fused, 50);
+    EXPECT_LT(result.maxError, 0.05);
+}